@@ -1,54 +1,44 @@
 #include "big_integer.h"
+#include "big_integer_kernels.h"
+#include "big_integer_magnitude.h"
+#include "big_integer_parallel.h"
 #include <algorithm>
+#include <cctype>
 #include <climits>
+#include <cstring>
 #include <vector>
 #include <functional>
 #include <cassert>
 #include <iostream>
 
-static const uint32_t BASE = UINT32_MAX; //not really base but actually BASE - 1
+using namespace big_integer_detail;
 
-static uint32_t filler(uint32_t x) { //the thing that we are using if we're filling the number in two complement form
-    return (x >> 31 ? BASE : 0);
-}
-
-static int maxbit(uint32_t n) { //Pre: n != 0
-    int temp = -1;
-    while (n) {
-        n >>= 1;
-        ++temp;
-    }
-    return temp;
+big_integer::big_integer(const big_integer &b) :
+    big_integer(b.data, b.size) {
 }
 
-big_integer::big_integer() :
-    big_integer(0) {
+big_integer::big_integer(big_integer_view v) :
+    big_integer(v.data(), v.size())
+{
+    normalize();
 }
 
-big_integer::big_integer(const big_integer &b) :
-    size(b.size),
-    data(new uint32_t[b.size])
+big_integer::big_integer(const uint32_t *limbs, size_t n) :
+    size(n),
+    data(new uint32_t[n])
 {
-    std::copy(b.data, b.data + size, data);
+    std::copy(limbs, limbs + n, data);
 }
 
-big_integer::big_integer(const std::string &s) :
-    big_integer(0)
+big_integer::big_integer(size_t n, uint32_t fill) :
+    size(n),
+    data(new uint32_t[n])
 {
-    bool neg = s[0] == '-';
-    for (size_t i = neg; i < s.size(); ++i) {
-        *this *= 10;
-        *this += s[i] - '0';
-    }
-    if (neg)
-        *this = -*this;
+    std::fill(data, data + n, fill);
 }
 
-big_integer::big_integer(int b) :
-    size(1),
-    data(new uint32_t[1])
-{
-    data[0] = b;
+big_integer::big_integer(const std::string &s) :
+    big_integer(from_string(s, 10)) {
 }
 
 big_integer::big_integer(uint32_t b) {
@@ -66,106 +56,127 @@ big_integer::big_integer(uint32_t b) {
 }
 
 big_integer::~big_integer() {
-    delete[] data;
+    release();
 }
 
 big_integer &big_integer::operator = (const big_integer &b) {
     uint32_t *ndata = new uint32_t[b.size];
     std::copy(b.data, b.data + b.size, ndata);
-    delete[] data;
+    release();
     size = b.size;
     data = ndata;
     return *this;
 }
 
-big_integer &big_integer::operator += (const big_integer &b) {
-    return *this = *this + b;
-}
-big_integer &big_integer::operator -= (const big_integer &b) {
-    return *this = *this - b;
-}
-big_integer &big_integer::operator *= (const big_integer &b) {
-    return *this = *this * b;
-}
-
-big_integer &big_integer::operator /= (const big_integer &b) {
-    return *this = *this / b;
-}
+//Above b's length b is all fill, i.e. all zeros or all ones, so the tail is either left alone, cut off (it ends
+//up all fill and normalize would drop it anyway) or inverted
 
-big_integer &big_integer::operator %= (const big_integer &b) {
-    return *this = *this % b;
+big_integer &big_integer::operator &= (big_integer_view b) {
+    unshare();
+    const size_t bsize = b.size();
+    if (size < bsize)
+        resize(bsize);
+    and_n(data, data, b.data(), bsize);
+    if (!b.negative())
+        size = bsize;
+    normalize();
+    return *this;
 }
 
-big_integer &big_integer::operator &= (const big_integer &b) {
-    if (size < b.size)
-        resize(b.size);
-    for (size_t i = 0; i < b.size; ++i)
-        data[i] &= b.data[i];
-    const uint32_t fill = filler(b.data[b.size - 1]);
-    for (size_t i = b.size; i < size; ++i)
-        data[i] &= fill;
+big_integer &big_integer::operator |= (big_integer_view b) {
+    unshare();
+    const size_t bsize = b.size();
+    if (size < bsize)
+        resize(bsize);
+    or_n(data, data, b.data(), bsize);
+    if (b.negative())
+        size = bsize;
     normalize();
     return *this;
 }
 
-big_integer &big_integer::operator |= (const big_integer &b) {
-    if (size < b.size)
-        resize(b.size);
-    for (size_t i = 0; i < b.size; ++i)
-        data[i] |= b.data[i];
-    const uint32_t fill = filler(b.data[b.size - 1]);
-    for (size_t i = b.size; i < size; ++i)
-        data[i] |= fill;
+big_integer &big_integer::operator ^= (big_integer_view b) {
+    unshare();
+    const size_t bsize = b.size();
+    if (size < bsize)
+        resize(bsize);
+    xor_n(data, data, b.data(), bsize);
+    if (b.negative())
+        not_n(data + bsize, data + bsize, size - bsize);
     normalize();
     return *this;
 }
 
-big_integer &big_integer::operator ^= (const big_integer &b) {
-    if (size < b.size)
-        resize(b.size);
-    for (size_t i = 0; i < b.size; ++i)
-        data[i] ^= b.data[i];
-    uint32_t fill = filler(b.data[b.size - 1]);
-    for (size_t i = b.size; i < size; ++i)
-        data[i] ^= fill;
+big_integer andnot(big_integer a, big_integer_view b) {
+    a.unshare();
+    const size_t bsize = b.size();
+    if (a.size < bsize)
+        a.resize(bsize);
+    andnot_n(a.data, a.data, b.data(), bsize);
+    if (b.negative())
+        a.size = bsize;
+    a.normalize();
+    return a;
+}
+
+//Both shifts touch every limb once: whole limbs move with a plain copy, the bits within a limb go through the
+//funnel shift kernels, which write straight into where the limbs end up
+
+void big_integer::shift_left_from(const uint32_t *a, size_t n, int b) {
+    const size_t bc = b >> 5, nsize = n + bc + 1;
+    const int br = b & 31;
+    uint32_t *r = new uint32_t[nsize];
+    const uint32_t fill = filler(a[n - 1]);
+    std::fill(r, r + bc, 0);
+    if (br != 0)
+        r[nsize - 1] = lshift(r + bc, a, n, br) | fill << br;
+    else {
+        std::copy(a, a + n, r + bc);
+        r[nsize - 1] = fill;
+    }
+    release();
+    data = r;
+    size = nsize;
     normalize();
-    return *this;
 }
 
 big_integer &big_integer::operator <<= (int b) {
     if (b < 0)
         return *this >>= -b;
-    size_t bc = b >> 5, br = b & 31;
-    resize(size + bc + 1);
-    for (size_t i = size - 1; i != (size_t)-1; --i)
-        data[i] = (i >= bc ? data[i - bc] : 0);
-    if (br != 0)
-        for (size_t i = size - 1; i != (size_t)-1; --i) {
-            data[i] <<= br;
-            if (i != 0)
-                data[i] |= (data[i - 1] >> (32 - br));
-        }
-    normalize();
+    shift_left_from(data, size, b);
     return *this;
 }
+
 big_integer &big_integer::operator >>= (int b) {
     if (b < 0)
         return *this <<= -b;
-    uint32_t as = filler(data[size - 1]);
-    size_t bc = b >> 5, br = b & 31;
-    for (size_t i = 0; i < size; ++i)
-        data[i] = (i + bc < size ? data[i + bc] : as);
-    if (br != 0)
-        for (size_t i = 0; i < size; ++i) {
-            data[i] >>= br;
-            data[i] |= (i + 1 == size ? as : data[i + 1]) << (32 - br);
-        }
+    unshare();
+    const uint32_t fill = filler(data[size - 1]);
+    const size_t bc = b >> 5;
+    const int br = b & 31;
+    if (bc >= size) {
+        data[0] = fill;
+        size = 1;
+        return *this;
+    }
+    const size_t n = size - bc;
+    if (br != 0) {
+        rshift(data, data + bc, n, br);
+        data[n - 1] |= fill << (32 - br);
+    }
+    else
+        std::memmove(data, data + bc, n * sizeof(uint32_t));
+    size = n;
     normalize();
     return *this;
 }
 
-big_integer big_integer::operator + () const {
-    return *this;
+big_integer operator << (const big_integer &a, int b) {
+    if (b < 0)
+        return a >> -b;
+    big_integer r;
+    r.shift_left_from(a.data, a.size, b);
+    return r;
 }
 
 big_integer big_integer::operator - () const {
@@ -174,54 +185,32 @@ big_integer big_integer::operator - () const {
 }
 
 big_integer big_integer::operator ~ () const {
-    big_integer r;
-    r.resize(size);
-    for (size_t i = 0; i < size; ++i)
-        r.data[i] = ~data[i];
+    big_integer r(size, 0);
+    not_n(r.data, data, size);
     return r;
 }
 
-big_integer &big_integer::operator ++ () {
-    return *this += 1;
-}
-
-big_integer &big_integer::operator -- () {
-    return *this -= 1;
-}
-
-big_integer big_integer::operator ++ (int) {
-    big_integer a = *this;
-    ++*this;
-    return a;
-}
-
-big_integer big_integer::operator -- (int) {
-    big_integer a = *this;
-    --*this;
-    return a;
-}
-
-big_integer operator + (big_integer a, const big_integer &b) {
-    //std::cerr << a << " " << b << "\n";
-    if (a.size < b.size)
-        a.resize(b.size);
+big_integer &big_integer::add_long(big_integer_view b) {
+    unshare();
+    big_integer &a = *this;
+    const uint32_t *bdata = b.data();
+    const size_t bsize = b.size();
+    if (a.size < bsize)
+        a.resize(bsize);
     uint32_t carry = 0;
-    //  std::cerr << to_string(a) << " " << to_string(b) << "\n";
     uint32_t afill = filler(a.data[a.size - 1]);
-    uint32_t bfill = filler(b.data[b.size - 1]);
-    //  std::cerr << afill << " " << bfill << "\n";
-    for (size_t i = 0; i < b.size; ++i) {
-        uint64_t sum = (uint64_t)a.data[i] + b.data[i] + carry;
+    uint32_t bfill = filler(bdata[bsize - 1]);
+    for (size_t i = 0; i < bsize; ++i) {
+        uint64_t sum = (uint64_t)a.data[i] + bdata[i] + carry;
         a.data[i] = (uint32_t)sum;
         carry = sum >> 32;
     }
-    for (size_t i = b.size; i < a.size && bfill + carry; ++i) {
+    for (size_t i = bsize; i < a.size && bfill + carry; ++i) {
         uint64_t sum = (uint64_t)a.data[i] + bfill + carry;
         a.data[i] = (uint32_t)sum;
         carry = sum >> 32;
     }
     uint32_t newfill = filler(a.data[a.size - 1]);
-    //  std::cerr << to_string(a) << "\n";
     if (afill + bfill + carry != newfill) {
         a.resize(a.size + 1);
         a.data[a.size - 1] = afill + bfill + carry;
@@ -230,18 +219,22 @@ big_integer operator + (big_integer a, const big_integer &b) {
     return a;
 }
 
-big_integer operator - (big_integer a, const big_integer &b) {
-    if (a.size < b.size)
-        a.resize(b.size);
+big_integer &big_integer::sub_long(big_integer_view b) {
+    unshare();
+    big_integer &a = *this;
+    const uint32_t *bdata = b.data();
+    const size_t bsize = b.size();
+    if (a.size < bsize)
+        a.resize(bsize);
     uint32_t carry = 0;
     uint32_t afill = filler(a.data[a.size - 1]);
-    uint32_t bfill = filler(b.data[b.size - 1]);
-    for (size_t i = 0; i < b.size; ++i) {
-        uint64_t diff = (uint64_t)a.data[i] - b.data[i] - carry;
+    uint32_t bfill = filler(bdata[bsize - 1]);
+    for (size_t i = 0; i < bsize; ++i) {
+        uint64_t diff = (uint64_t)a.data[i] - bdata[i] - carry;
         a.data[i] = (uint32_t)diff;
         carry = diff >> 63;
     }
-    for (size_t i = b.size; i < a.size && bfill + carry; ++i) {
+    for (size_t i = bsize; i < a.size && bfill + carry; ++i) {
         uint64_t diff = (uint64_t)a.data[i] - bfill - carry;
         a.data[i] = (uint32_t)diff;
         carry = diff >> 63;
@@ -255,222 +248,825 @@ big_integer operator - (big_integer a, const big_integer &b) {
     return a;
 }
 
-big_integer operator * (const big_integer &a, const big_integer &b) {
-    if (a < 0) {
-        if (b < 0)
-            return (-a) * (-b);
-        else
-            return -((-a) * b);
-    }
-    else if (b < 0)
-        return -(a * (-b));
-    big_integer r;
-    r.resize(a.size + b.size);
-    for (size_t i = 0; i < a.size; ++i) {
-        uint32_t carry = 0;
-        for (size_t j = 0; j < b.size; ++j) {
-            uint64_t res = (uint64_t)a.data[i] * b.data[j] + carry + r.data[i + j];
-            r.data[i + j] = (uint32_t)res;
-            carry = res >> 32;
+big_integer big_integer::multiply(big_integer_view a, big_integer_view b) {
+    return multiply(a, b, default_thread_pool());
+}
+
+big_integer big_integer::multiply(big_integer_view a, big_integer_view b, thread_pool *pool) {
+    std::vector<uint32_t> as, bs;
+    size_t an, bn;
+    const uint32_t *am = magnitude(a, as, an), *bm = magnitude(b, bs, bn);
+    if (an == 0 || bn == 0)
+        return 0;
+    big_integer r(an + bn + 1, 0);
+    if (pool)
+        mul_parallel(r.data, am, an, bm, bn, *pool);
+    else
+        mul_basecase(r.data, am, an, bm, bn);
+    if (a.negative() != b.negative())
+        negate(r.data, r.data, r.size);
+    r.normalize();
+    return r;
+}
+
+//truncating division like the built-in one: the quotient is rounded towards zero, the remainder gets the sign of a
+std::pair <big_integer, big_integer> big_integer::divMod(big_integer_view a, big_integer_view b) {
+    std::vector<uint32_t> as, bs;
+    size_t an, bn;
+    const uint32_t *am = magnitude(a, as, an), *bm = magnitude(b, bs, bn);
+    if (cmp(am, an, bm, bn) < 0)
+        return{ 0, big_integer(a) };
+    big_integer q(an - bn + 2, 0), r(bn + 1, 0);
+    divrem(q.data, r.data, am, an, bm, bn);
+    if (a.negative() != b.negative())
+        negate(q.data, q.data, q.size);
+    if (a.negative())
+        negate(r.data, r.data, r.size);
+    q.normalize();
+    r.normalize();
+    return{ std::move(q), std::move(r) };
+}
+
+big_integer mul(big_integer_view a, big_integer_view b, thread_pool &pool) {
+    return big_integer::multiply(a, b, &pool);
+}
+
+big_integer pow(big_integer_view base, unsigned exp) {
+    if (exp == 0)
+        return 1;
+    std::vector<uint32_t> m;
+    magnitude(base, m);
+    if (m.empty())
+        return 0;
+    const bool neg = base.negative() && (exp & 1);
+    //|base| = odd * 2^twos, the twos go into the final shift
+    size_t zero_limbs = 0;
+    while (m[zero_limbs] == 0)
+        ++zero_limbs;
+    const int zero_bits = maxbit(m[zero_limbs] & -m[zero_limbs]);
+    m.erase(m.begin(), m.begin() + zero_limbs);
+    if (zero_bits)
+        rshift(m.data(), m.data(), m.size(), zero_bits);
+    m.resize(strip(m.data(), m.size()));
+    const size_t twos = (zero_limbs * 32 + zero_bits) * (size_t)exp;
+
+    //odd^exp has at most bits(odd) * exp bits; the squaring step may write up to two limbs past that
+    size_t mn = m.size();
+    const size_t bound = bit_length(m.data(), mn) * (size_t)exp / 32 + 3;
+    unsigned e = exp;
+    uint32_t tail = 1; //a factor left over from folding a one-limb base
+    if (mn == 1 && m[0] != 1) {
+        uint32_t folded = m[0];
+        unsigned per_limb = 1;
+        while ((uint64_t)folded * m[0] <= UINT32_MAX) {
+            folded *= m[0];
+            ++per_limb;
         }
-        for (size_t j = b.size; i + j < r.size && carry; ++j) {
-            uint64_t res = (uint64_t)carry + r.data[i + j];
-            r.data[i + j] = (uint32_t)res;
-            carry = res >> 32;
+        for (unsigned i = 0; i < e % per_limb; ++i)
+            tail *= m[0];
+        e /= per_limb;
+        m[0] = folded;
+    }
+    std::vector<uint32_t> x(bound), y(bound);
+    size_t xn = 1;
+    x[0] = 1;
+    if (e > 0 && !(mn == 1 && m[0] == 1)) {
+        //left to right: square, and multiply by m where the exponent has a one
+        std::copy(m.begin(), m.end(), x.begin());
+        xn = mn;
+        for (int bit = maxbit(e) - 1; bit >= 0; --bit) {
+            sqr_basecase(y.data(), x.data(), xn);
+            xn = strip(y.data(), 2 * xn);
+            x.swap(y);
+            if (e >> bit & 1) {
+                if (mn == 1)
+                    x[xn] = mul_1(x.data(), x.data(), xn, m[0]);
+                else {
+                    mul_basecase(y.data(), x.data(), xn, m.data(), mn);
+                    x.swap(y);
+                }
+                xn = strip(x.data(), xn + mn);
+            }
         }
     }
+    if (tail != 1) {
+        x[xn] = mul_1(x.data(), x.data(), xn, tail);
+        xn = strip(x.data(), xn + 1);
+    }
+    //the result is x << twos, plus a limb for the sign
+    big_integer r(xn + twos / 32 + 2, 0);
+    const int bits = twos % 32;
+    if (bits)
+        r.data[xn + twos / 32] = lshift(r.data + twos / 32, x.data(), xn, bits);
+    else
+        std::copy(x.begin(), x.begin() + xn, r.data + twos / 32);
+    if (neg)
+        negate(r.data, r.data, r.size);
     r.normalize();
     return r;
 }
 
-std::pair <big_integer, big_integer> big_integer::divMod(const big_integer &b) {
-    if (*this < b)
-        return{ 0, *this };
-    if (b.size == 1 || b.size == 2 && b.data[1] == 0) {
-        uint32_t carry = 0;
-        for (uint32_t i = size; i--; ) {
-            uint64_t cur = data[i] + carry * (1LL << 32);
-            data[i] = (uint32_t)(cur / b.data[0]);
-            carry = (uint32_t)(cur % b.data[0]);
+bool big_integer::equal_long(big_integer_view a, big_integer_view b) {
+    const uint32_t *ad = a.data(), *bd = b.data();
+    const size_t as = a.size(), bs = b.size();
+    if (diff_length(ad, bd, std::min(as, bs)) != 0)
+        return false;
+    if (as < bs)
+        return strip_fill(bd + as, bs - as, filler(ad[as - 1])) == 0;
+    return strip_fill(ad + bs, as - bs, filler(bd[bs - 1])) == 0;
+}
+
+int big_integer::compare_long(big_integer_view a, big_integer_view b) {
+    const uint32_t *ad = a.data(), *bd = b.data();
+    const size_t as = a.size(), bs = b.size();
+    uint32_t afill = filler(ad[as - 1]);
+    uint32_t bfill = filler(bd[bs - 1]);
+    if (afill != bfill)
+        return afill ? -1 : 1;
+    if (bs > as) { //the part of b above a against the sign extension of a
+        size_t n = strip_fill(bd + as, bs - as, afill);
+        if (n != 0)
+            return afill < bd[as + n - 1] ? -1 : 1;
+    }
+    if (as > bs) {
+        size_t n = strip_fill(ad + bs, as - bs, bfill);
+        if (n != 0)
+            return ad[bs + n - 1] < bfill ? -1 : 1;
+    }
+    return cmp(ad, bd, std::min(as, bs));
+}
+
+namespace
+{
+    const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    const size_t CONVERSION_DC_THRESHOLD = 30; //limbs, below that the quadratic loops are faster
+    const size_t TO_CHARS_STACK_LIMBS = 512; //about 4900 decimal digits, to_chars and from_chars stay off the heap up to that
+
+    struct radix
+    {
+        uint32_t base;
+        uint32_t big_base; //the biggest power of base that fits into a limb
+        size_t digits; //how many digits big_base has
+        int bits; //log2(base) for the powers of two, 0 otherwise
+    };
+
+    radix make_radix(int base) {
+        radix rd = { (uint32_t)base, (uint32_t)base, 1, 0 };
+        while ((uint64_t)rd.big_base * rd.base <= UINT32_MAX) {
+            rd.big_base *= rd.base;
+            ++rd.digits;
+        }
+        if ((base & (base - 1)) == 0)
+            rd.bits = maxbit(base);
+        return rd;
+    }
+
+    bool valid_base(int base) {
+        return base >= 2 && base <= 36;
+    }
+
+    //36 for anything that isn't a digit, so checking digit_value(c) < base is enough for any base
+    int digit_value(char c) {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'z')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'Z')
+            return c - 'A' + 10;
+        return 36;
+    }
+
+    //how many big_base digits a number of n limbs can have at most
+    size_t chunk_count(const radix &rd, size_t n) {
+        return n * 32 / maxbit(rd.big_base) + 1;
+    }
+
+    //powers[i] = big_base^(2^i) for every i with 2^i < chunks
+    std::vector<std::vector<uint32_t>> radix_powers(const radix &rd, size_t chunks, thread_pool *pool = nullptr) {
+        std::vector<std::vector<uint32_t>> powers(1, std::vector<uint32_t>(1, rd.big_base));
+        while (((size_t)1 << powers.size()) < chunks) {
+            const std::vector<uint32_t> &p = powers.back();
+            std::vector<uint32_t> sq(p.size() * 2);
+            if (pool)
+                mul_parallel(sq.data(), p.data(), p.size(), p.data(), p.size(), *pool);
+            else
+                mul_basecase(sq.data(), p.data(), p.size(), p.data(), p.size());
+            sq.resize(strip(sq.data(), sq.size()));
+            powers.push_back(sq);
         }
-        normalize();
-        return{ *this, carry };
-    }
-    if (b.data[b.size - 1] != 0) {
-        int shift = 31 - maxbit(b.data[b.size - 1]);
-        auto qr = (*this << shift).divMod(b << shift);
-        return{ qr.first, qr.second >> shift };
-    }
-    //make b proper
-    size_t m = size - (data[size - 1] == 0);
-    size_t n = b.size - (b.data[b.size - 1] == 0);
-    m -= n;
-    big_integer q;
-    q.resize(m + 2);
-    if (*this >= (b << (m * 32))) {
-        q.data[m] = 1;
-        *this -= (b << (m * 32));
-    }
-    for (size_t j = m; j--; ) {
-        if (n + j >= size)
-            continue;
-        uint64_t temp = ((static_cast<uint64_t>(data[n + j]) << 32) + data[n + j - 1]) / b.data[n - 1];
-        if (temp >> 32) {
-            q.data[j] = BASE;
+        return powers;
+    }
+
+    //linear time, every digit is just a group of bits
+    size_t pow2_digit_count(const uint32_t *a, size_t n, const radix &rd) {
+        return (bit_length(a, n) + rd.bits - 1) / rd.bits;
+    }
+
+    void to_chars_pow2(char *first, const uint32_t *a, size_t n, size_t count, const radix &rd) {
+        for (size_t d = 0; d < count; ++d) {
+            size_t bit = d * rd.bits, limb = bit / 32, off = bit % 32;
+            uint32_t v = a[limb] >> off;
+            if (off + rd.bits > 32 && limb + 1 < n)
+                v |= a[limb + 1] << (32 - off);
+            first[count - 1 - d] = DIGITS[v & (rd.base - 1)];
         }
-        else {
-            q.data[j] = static_cast<uint32_t>(temp);
+    }
+
+    std::string to_string_pow2(const uint32_t *a, size_t n, const radix &rd) {
+        std::string s(pow2_digit_count(a, n, rd), '0');
+        to_chars_pow2(&s[0], a, n, s.size(), rd);
+        return s;
+    }
+
+    //writes the digits of x right to left ending at last, returns where they start. x is destroyed.
+    //With pad exactly digits * 2^level digits are written, x must be below powers[level] then
+    char *to_chars_dc(char *last, uint32_t *x, size_t n, const std::vector<std::vector<uint32_t>> &powers,
+                      size_t level, const radix &rd, bool pad) {
+        n = strip(x, n);
+        if (level > 0 && n >= CONVERSION_DC_THRESHOLD) {
+            const std::vector<uint32_t> &d = powers[level - 1];
+            if (cmp(x, n, d.data(), d.size()) < 0) {
+                char *p = to_chars_dc(last, x, n, powers, level - 1, rd, pad);
+                if (pad)
+                    while ((size_t)(last - p) < rd.digits << level)
+                        *--p = '0';
+                return p;
+            }
+            //x = q * big_base^(2^(level - 1)) + r, the low half always has all of its digits
+            std::vector<uint32_t> q(n - d.size() + 1), r(d.size());
+            divrem(q.data(), r.data(), x, n, d.data(), d.size());
+            char *mid = to_chars_dc(last, r.data(), r.size(), powers, level - 1, rd, true);
+            return to_chars_dc(mid, q.data(), q.size(), powers, level - 1, rd, pad);
         }
-        *this -= q.data[j] * (b << (j * 32));
-        while (*this < 0) {
-            --q.data[j];
-            *this += (b << (j * 32));
+        char *p = last;
+        while (n > 0) {
+            uint32_t r = divrem_1(x, x, n, rd.big_base);
+            n = strip(x, n);
+            for (size_t i = 0; i < rd.digits && (n > 0 || r != 0 || pad); ++i) {
+                *--p = DIGITS[r % rd.base];
+                r /= rd.base;
+            }
         }
+        if (pad)
+            while ((size_t)(last - p) < rd.digits << level)
+                *--p = '0';
+        return p;
     }
-    q.normalize();
-    normalize();
-    return{ q, *this };
-}
 
-big_integer operator / (big_integer a, const big_integer &b) {
-    if (a < 0)
-        if (b < 0)
-            return (-a) / (-b);
-        else
-            return -((-a) / b);
-    else if (b < 0)
-        return -(a / (-b));
-    return a.divMod(b).first;
-}
+    void write_zeros(std::ostream &out, size_t count) {
+        static const char ZEROS[] = "00000000000000000000000000000000000000000000000000000000000000000";
+        for (; count > 0 && out; count -= std::min(count, sizeof(ZEROS) - 1))
+            out.write(ZEROS, std::min(count, sizeof(ZEROS) - 1));
+    }
+
+    //same recursion as to_chars_dc, but the high half goes first so the digits can be written out as soon as
+    //they are known; only a base case worth of them is ever kept
+    void write_chars_dc(std::ostream &out, uint32_t *x, size_t n, const std::vector<std::vector<uint32_t>> &powers,
+                        size_t level, const radix &rd, bool pad) {
+        n = strip(x, n);
+        if (level > 0 && n >= CONVERSION_DC_THRESHOLD) {
+            const std::vector<uint32_t> &d = powers[level - 1];
+            if (cmp(x, n, d.data(), d.size()) < 0) {
+                if (pad)
+                    write_zeros(out, rd.digits << (level - 1));
+                write_chars_dc(out, x, n, powers, level - 1, rd, pad);
+                return;
+            }
+            std::vector<uint32_t> q(n - d.size() + 1), r(d.size());
+            divrem(q.data(), r.data(), x, n, d.data(), d.size());
+            write_chars_dc(out, q.data(), q.size(), powers, level - 1, rd, pad);
+            write_chars_dc(out, r.data(), r.size(), powers, level - 1, rd, true);
+            return;
+        }
+        char buf[CONVERSION_DC_THRESHOLD * 32 + 32];
+        char *last = buf + sizeof(buf);
+        char *first = to_chars_dc(last, x, n, powers, 0, rd, false);
+        if (pad)
+            write_zeros(out, (rd.digits << level) - (last - first));
+        out.write(first, last - first);
+    }
+
+    //linear time, digits are put straight into their bit positions
+    void from_string_pow2(std::vector<uint32_t> &r, const char *first, const char *last, const radix &rd) {
+        r.assign(((last - first) * rd.bits + 31) / 32 + 1, 0);
+        size_t bit = 0;
+        for (const char *p = last; p-- != first; bit += rd.bits) {
+            uint32_t v = digit_value(*p);
+            size_t limb = bit / 32, off = bit % 32;
+            r[limb] |= v << off;
+            if (off + rd.bits > 32)
+                r[limb + 1] |= v >> (32 - off);
+        }
+    }
+
+    //chunks are big_base digits, least significant first; the value goes to r[0, n + 1)
+    void from_chunks_dc(uint32_t *r, const uint32_t *chunks, size_t n, const std::vector<std::vector<uint32_t>> &powers,
+                        size_t level) {
+        while (level > 0 && ((size_t)1 << (level - 1)) >= n)
+            --level;
+        std::fill(r, r + n + 1, 0);
+        if (level == 0 || n < CONVERSION_DC_THRESHOLD) {
+            for (size_t i = n; i--; ) {
+                size_t len = n - i; //the value so far is below big_base^len, so neither step can carry out
+                mul_1(r, r, len, powers[0][0]);
+                add_1(r, r, len, chunks[i]);
+            }
+            return;
+        }
+        //value = high * big_base^half + low
+        size_t half = (size_t)1 << (level - 1);
+        const std::vector<uint32_t> &p = powers[level - 1];
+        std::vector<uint32_t> low(half + 1), high(n - half + 1);
+        from_chunks_dc(low.data(), chunks, half, powers, level - 1);
+        from_chunks_dc(high.data(), chunks + half, n - half, powers, level - 1);
+        size_t hn = strip(high.data(), high.size());
+        if (hn)
+            mul_basecase(r, high.data(), hn, p.data(), p.size());
+        add(r, r, n + 1, low.data(), strip(low.data(), low.size()));
+    }
 
-big_integer operator % (big_integer a, const big_integer &b) {
-    if (a < 0)
-        if (b < 0)
-            return -(-a) % (-b);
+    //to_chars_dc with the top of the tree taken apart breadth first: the divisions of a level run side by side on
+    //the pool until there are a few pieces per thread or the divisors get shorter than the grain, then the pieces
+    //are finished as whole subtrees. A piece always ends at a fixed place in the output, so they never overlap
+    char *to_chars_parallel(char *last, const uint32_t *x, size_t n, const std::vector<std::vector<uint32_t>> &powers,
+                            const radix &rd, thread_pool &pool) {
+        struct piece
+        {
+            std::vector<uint32_t> x;
+            char *last;
+            bool pad;
+        };
+        std::vector<piece> pieces(1, piece{ std::vector<uint32_t>(x, x + n), last, false });
+        size_t level = powers.size();
+        while (level > 0 && pieces.size() < 4 * pool.threads() && powers[level - 1].size() >= pool.grain()) {
+            const std::vector<uint32_t> &d = powers[level - 1];
+            const size_t width = rd.digits << (level - 1);
+            std::vector<piece> next(2 * pieces.size());
+            pool.parallel_for(pieces.size(), [&](size_t i) {
+                piece &p = pieces[i], &high = next[2 * i], &low = next[2 * i + 1];
+                const size_t pn = strip(p.x.data(), p.x.size());
+                high.last = p.last - width;
+                high.pad = p.pad;
+                low.last = p.last;
+                if (cmp(p.x.data(), pn, d.data(), d.size()) < 0) { //nothing for the high half but maybe zeros
+                    low.x = std::move(p.x);
+                    low.pad = p.pad;
+                    return;
+                }
+                high.x.resize(pn - d.size() + 1);
+                low.x.resize(d.size());
+                low.pad = true;
+                divrem(high.x.data(), low.x.data(), p.x.data(), pn, d.data(), d.size());
+            });
+            pieces = std::move(next);
+            --level;
+        }
+        std::vector<char *> first(pieces.size());
+        pool.parallel_for(pieces.size(), [&](size_t i) {
+            piece &p = pieces[i];
+            first[i] = to_chars_dc(p.last, p.x.data(), p.x.size(), powers, level, rd, p.pad);
+        });
+        //the leading pieces may be empty, the digits start with the first one that has some
+        size_t i = 0;
+        while (first[i] == pieces[i].last)
+            ++i;
+        return first[i];
+    }
+
+    //from_chunks_dc bottom up: blocks of 2^j chunks are converted side by side, then neighbours are joined level by
+    //level. A level with fewer joins than threads does them one after another with parallel multiplications instead
+    void from_chunks_parallel(std::vector<uint32_t> &r, const uint32_t *chunks, size_t n,
+                              const std::vector<std::vector<uint32_t>> &powers, thread_pool &pool) {
+        size_t j = 0;
+        while (((size_t)1 << j) < pool.grain() || (n >> j) > 4 * pool.threads())
+            ++j;
+        const size_t block = (size_t)1 << j;
+        std::vector<std::vector<uint32_t>> v((n + block - 1) / block);
+        pool.parallel_for(v.size(), [&](size_t k) {
+            const size_t len = std::min(block, n - k * block);
+            v[k].resize(len + 1);
+            from_chunks_dc(v[k].data(), chunks + k * block, len, powers, powers.size());
+            v[k].resize(strip(v[k].data(), v[k].size()));
+        });
+        for (; v.size() > 1; ++j) {
+            //next[k] = v[2k + 1] * big_base^(2^j) + v[2k]
+            std::vector<std::vector<uint32_t>> next((v.size() + 1) / 2);
+            const std::vector<uint32_t> &p = powers[j];
+            auto join = [&](size_t k, thread_pool *inner) {
+                if (2 * k + 1 == v.size()) {
+                    next[k] = std::move(v[2 * k]);
+                    return;
+                }
+                const std::vector<uint32_t> &high = v[2 * k + 1], &low = v[2 * k];
+                std::vector<uint32_t> &w = next[k];
+                w.assign(high.size() + p.size() + 1, 0);
+                if (!high.empty() && inner)
+                    mul_parallel(w.data(), high.data(), high.size(), p.data(), p.size(), *inner);
+                else if (!high.empty())
+                    mul_basecase(w.data(), high.data(), high.size(), p.data(), p.size());
+                add(w.data(), w.data(), w.size(), low.data(), low.size());
+                w.resize(strip(w.data(), w.size()));
+            };
+            if (next.size() >= pool.threads())
+                pool.parallel_for(next.size(), [&](size_t k) { join(k, nullptr); });
+            else
+                for (size_t k = 0; k < next.size(); ++k)
+                    join(k, &pool);
+            v = std::move(next);
+        }
+        r = std::move(v[0]);
+    }
+
+    //the magnitude of the digits in [first, last)
+    void parse_magnitude(std::vector<uint32_t> &r, const char *first, const char *last, const radix &rd,
+                         thread_pool *pool) {
+        if (rd.bits) {
+            from_string_pow2(r, first, last, rd);
+            return;
+        }
+        //group the digits into limbs from the right, then combine the groups pairwise
+        std::vector<uint32_t> chunks((last - first + rd.digits - 1) / rd.digits);
+        if (pool && (pool->threads() < 2 || chunks.size() < 2 * pool->grain()))
+            pool = nullptr;
+        auto parse = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const char *e = last - i * rd.digits;
+                const char *b = e - std::min<size_t>(rd.digits, e - first);
+                for (const char *p = b; p != e; ++p)
+                    chunks[i] = chunks[i] * rd.base + digit_value(*p);
+            }
+        };
+        std::vector<std::vector<uint32_t>> powers = radix_powers(rd, chunks.size(), pool);
+        if (!pool) {
+            parse(0, chunks.size());
+            r.resize(chunks.size() + 1);
+            from_chunks_dc(r.data(), chunks.data(), chunks.size(), powers, powers.size());
+            return;
+        }
+        const size_t step = (chunks.size() + pool->threads() - 1) / pool->threads();
+        pool->parallel_for(pool->threads(), [&](size_t t) {
+            parse(std::min(t * step, chunks.size()), std::min((t + 1) * step, chunks.size()));
+        });
+        from_chunks_parallel(r, chunks.data(), chunks.size(), powers, *pool);
+    }
+
+    //the magnitude of a number with an optional sign goes to r, returns whether it's negative
+    bool parse_string(std::vector<uint32_t> &r, const char *first, const char *last, int base, thread_pool *pool) {
+        bool neg = first != last && *first == '-';
+        if (first != last && (*first == '-' || *first == '+'))
+            ++first;
+        assert(valid_base(base));
+        assert(std::all_of(first, last, [base](char c) { return digit_value(c) < base; }));
+        radix rd = make_radix(base);
+        parse_magnitude(r, first, last, rd, pool);
+        return neg;
+    }
+
+    to_chars_result to_chars_on(char *first, char *last, big_integer_view a, int base, thread_pool *pool) {
+        const size_t n = a.size();
+        uint32_t stack[TO_CHARS_STACK_LIMBS];
+        std::vector<uint32_t> heap;
+        uint32_t *m = stack;
+        if (n > TO_CHARS_STACK_LIMBS) {
+            heap.resize(n);
+            m = heap.data();
+        }
+        const bool neg = a.negative();
+        if (neg)
+            negate(m, a.data(), n);
         else
-            return -((-a) % b);
-    else if (b < 0)
-        return (a % (-b));
-    return a.divMod(b).second;
+            std::copy(a.data(), a.data() + n, m);
+        size_t mn = strip(m, n);
+        size_t room = last - first;
+        if (mn == 0) {
+            if (room == 0)
+                return{ last, std::errc::value_too_large };
+            *first = '0';
+            return{ first + 1, std::errc() };
+        }
+        radix rd = make_radix(base);
+        if (rd.bits) {
+            size_t count = pow2_digit_count(m, mn, rd);
+            if (room < neg + count)
+                return{ last, std::errc::value_too_large };
+            if (neg)
+                *first = '-';
+            to_chars_pow2(first + neg, m, mn, count, rd);
+            return{ first + neg + count, std::errc() };
+        }
+        //the digits come out right to left, so they are written to the end of a buffer that surely fits them and
+        //moved into place afterwards; that buffer is the output itself whenever it is big enough
+        size_t bound = chunk_count(rd, mn) * rd.digits;
+        char small[TO_CHARS_STACK_LIMBS * 10];
+        std::string big;
+        char *end = last;
+        if (room < bound) {
+            if (bound <= sizeof(small))
+                end = small + bound;
+            else {
+                big.resize(bound);
+                end = &big[0] + bound;
+            }
+        }
+        char *digits;
+        if (mn <= TO_CHARS_STACK_LIMBS) {
+            //the quadratic loop needs no memory, and at this size it's about as fast as the recursive one anyway
+            digits = to_chars_dc(end, m, mn, std::vector<std::vector<uint32_t>>(), 0, rd, false);
+        }
+        else if (pool && pool->threads() > 1 && mn >= 2 * pool->grain()) {
+            std::vector<std::vector<uint32_t>> powers = radix_powers(rd, chunk_count(rd, mn), pool);
+            digits = to_chars_parallel(end, m, mn, powers, rd, *pool);
+        }
+        else {
+            std::vector<std::vector<uint32_t>> powers = radix_powers(rd, chunk_count(rd, mn));
+            digits = to_chars_dc(end, m, mn, powers, powers.size(), rd, false);
+        }
+        size_t count = end - digits;
+        if (room < neg + count)
+            return{ last, std::errc::value_too_large };
+        if (neg)
+            *first = '-';
+        std::memmove(first + neg, digits, count);
+        return{ first + neg + count, std::errc() };
+    }
 }
 
-big_integer operator & (big_integer a, const big_integer &b) {
-    return a &= b;
-}
-big_integer operator | (big_integer a, const big_integer &b) {
-    return a |= b;
+big_integer from_string(const std::string &s, int base) {
+    return from_string(s.data(), s.data() + s.size(), base);
 }
-big_integer operator ^ (big_integer a, const big_integer &b) {
-    return a ^= b;
+
+big_integer from_string(const char *first, const char *last, int base) {
+    std::vector<uint32_t> r;
+    bool neg = parse_string(r, first, last, base, default_thread_pool());
+    big_integer a = from_magnitude(r.data(), r.size());
+    return neg ? -a : a;
 }
 
-big_integer operator << (big_integer a, int b) {
-    return a <<= b;
+big_integer from_string(const char *first, const char *last, int base, thread_pool &pool) {
+    std::vector<uint32_t> r;
+    bool neg = parse_string(r, first, last, base, &pool);
+    big_integer a = from_magnitude(r.data(), r.size());
+    return neg ? -a : a;
 }
 
-big_integer operator >> (big_integer a, int b) {
-    return a >>= b;
+to_chars_result to_chars(char *first, char *last, big_integer_view a, int base) {
+    if (!valid_base(base))
+        return{ first, std::errc::invalid_argument };
+    return to_chars_on(first, last, a, base, default_thread_pool());
 }
 
-bool operator == (const big_integer &a, const big_integer &b) {
-    for (size_t i = 0; i < std::min(a.size, b.size); ++i)
-        if (a.data[i] != b.data[i])
-            return false;
-    uint32_t afill = filler(a.data[a.size - 1]);
-    for (size_t i = a.size; i < b.size; ++i)
-        if (afill != b.data[i])
-            return false;
-    uint32_t bfill = filler(b.data[b.size - 1]);
-    for (size_t i = b.size; i < a.size; ++i)
-        if (bfill != a.data[i])
-            return false;
-    return true;
+std::string to_string(big_integer_view a, int base, thread_pool &pool) {
+    assert(valid_base(base));
+    std::string s(to_chars_size(a, base), '\0');
+    s.resize(to_chars_on(&s[0], &s[0] + s.size(), a, base, &pool).ptr - &s[0]);
+    return s;
 }
 
-bool operator != (const big_integer &a, const big_integer &b) {
-    return !(a == b);
+size_t to_chars_size(big_integer_view a, int base) {
+    assert(valid_base(base));
+    radix rd = make_radix(base);
+    return 1 + chunk_count(rd, a.size()) * rd.digits;
 }
 
-bool operator < (const big_integer &a, const big_integer &b) {
-    uint32_t afill = filler(a.data[a.size - 1]);
-    uint32_t bfill = filler(b.data[b.size - 1]);
-    if (afill != bfill)
-        return afill > bfill;
-    for (size_t i = b.size; i-- > a.size;)
-        if (afill != b.data[i])
-            return afill < b.data[i];
-    for (size_t i = a.size; i-- > b.size;)
-        if (bfill != a.data[i])
-            return a.data[i] < bfill;
-    for (size_t i = std::min(a.size, b.size); i--; )
-        if (a.data[i] != b.data[i])
-            return a.data[i] < b.data[i];
-    return false;
+from_chars_result from_chars(const char *first, const char *last, big_integer &value, int base) {
+    if (!valid_base(base))
+        return{ first, std::errc::invalid_argument };
+    const char *p = first;
+    bool neg = p != last && *p == '-';
+    p += neg;
+    const char *digits = p;
+    while (p != last && digit_value(*p) < base)
+        ++p;
+    if (p == digits)
+        return{ first, std::errc::invalid_argument };
+    radix rd = make_radix(base);
+    size_t n = ((p - digits) * (maxbit(base) + 1) + 31) / 32 + 1; //an upper bound for the magnitude
+    if (n > TO_CHARS_STACK_LIMBS) {
+        value = from_string(first, p, base);
+        return{ p, std::errc() };
+    }
+    //Horner's scheme a whole limb worth of digits at a time
+    uint32_t m[TO_CHARS_STACK_LIMBS + 1];
+    size_t len = 0;
+    for (const char *q = digits; q != p; ) {
+        uint32_t chunk = 0, scale = 1;
+        for (size_t i = 0; i < rd.digits && q != p; ++i, ++q) {
+            chunk = chunk * rd.base + digit_value(*q);
+            scale *= rd.base;
+        }
+        //m * scale + chunk < (m + 1) * scale, so one new limb is always enough
+        uint32_t top = mul_1(m, m, len, scale);
+        top += add_1(m, m, len, chunk);
+        if (top)
+            m[len++] = top;
+    }
+    value.resize(len + 1); //shrinking keeps the buffer, so a reused value doesn't allocate
+    std::copy(m, m + len, value.data);
+    value.data[len] = 0;
+    if (neg)
+        negate(value.data, value.data, len + 1);
+    value.normalize();
+    return{ p, std::errc() };
 }
 
-bool operator > (const big_integer &a, const big_integer &b) {
-    return b < a;
+std::string to_string(big_integer_view a, int base) {
+    assert(valid_base(base));
+    std::string s(to_chars_size(a, base), '\0');
+    s.resize(to_chars(&s[0], &s[0] + s.size(), a, base).ptr - &s[0]);
+    return s;
 }
 
-bool operator <= (const big_integer &a, const big_integer &b) {
-    return !(b < a);
+std::string to_string(const big_integer &a) {
+    return to_string(a, 10);
 }
 
-bool operator >= (const big_integer &a, const big_integer &b) {
-    return !(a < b);
+std::ostream &write_string(std::ostream &out, big_integer_view a, int base) {
+    assert(valid_base(base));
+    std::vector<uint32_t> m;
+    magnitude(a, m);
+    if (m.empty())
+        return out.put('0');
+    if (a.negative())
+        out.put('-');
+    radix rd = make_radix(base);
+    if (rd.bits)
+        return out << to_string_pow2(m.data(), m.size(), rd);
+    std::vector<std::vector<uint32_t>> powers = radix_powers(rd, chunk_count(rd, m.size()));
+    write_chars_dc(out, m.data(), m.size(), powers, powers.size(), rd, false);
+    return out;
 }
 
-std::string to_string(big_integer a) {
-    if (a == 0)
-        return "0";
-    std::string s;
-    bool neg = false;
-    if (a < 0) {
-        neg = true;
-        a = -a;
-    }
-    while (a != 0) {
-        auto lr = a.divMod(10);
-        s.push_back('0' + static_cast<int>(lr.second.data[0]));
-        a = lr.first;
+static int stream_base(const std::ios_base &s) {
+    switch (s.flags() & std::ios_base::basefield) {
+    case std::ios_base::hex:
+        return 16;
+    case std::ios_base::oct:
+        return 8;
+    default:
+        return 10;
     }
-    if (neg)
-        s.push_back('-');
-    std::reverse(s.begin(), s.end());
-    return s;
 }
 
 std::istream &operator >> (std::istream &in, big_integer &a) {
     std::string s;
     in >> s;
-    a = big_integer(s);
+    int base = stream_base(in);
+    size_t sign = !s.empty() && (s[0] == '-' || s[0] == '+');
+    if (base == 16 && s.size() > sign + 1 && s[sign] == '0' && (s[sign + 1] == 'x' || s[sign + 1] == 'X'))
+        s.erase(sign, 2);
+    a = from_string(s, base);
     return in;
 }
 
 std::ostream &operator << (std::ostream &out, const big_integer &a) {
-    return out << to_string(a);
+    int base = stream_base(out);
+    std::ios_base::fmtflags flags = out.flags();
+    //three characters in front for the base prefix and the sign
+    const size_t size = to_chars_size(a, base) + 3;
+    char small[256];
+    std::vector<char> big;
+    char *buf = small;
+    if (size > sizeof(small)) {
+        big.resize(size);
+        buf = big.data();
+    }
+    char *first = buf + 3, *last = to_chars(first, buf + size, a, base).ptr;
+    bool neg = *first == '-';
+    first += neg;
+    if (flags & std::ios_base::uppercase)
+        std::transform(first, last, first, [](char c) { return (char)std::toupper((unsigned char)c); });
+    //like num_put, zero gets no prefix, so it is 0 rather than 0x0 or 00
+    if (flags & std::ios_base::showbase && base != 10 && !(last - first == 1 && *first == '0')) {
+        if (base == 16)
+            *--first = flags & std::ios_base::uppercase ? 'X' : 'x';
+        *--first = '0';
+    }
+    if (neg)
+        *--first = '-';
+    else if (flags & std::ios_base::showpos)
+        *--first = '+';
+    if (out.width() != 0)
+        return out << std::string(first, last); //let the stream pad it
+    return out.write(first, last - first);
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static const bool LITTLE_ENDIAN_LIMBS = true;
+#else
+static const bool LITTLE_ENDIAN_LIMBS = false;
+#endif
+
+size_t serialized_size(big_integer_view a) {
+    size_t header = 1;
+    for (size_t n = a.size(); n >= 0x80; n >>= 7)
+        ++header;
+    return header + a.size() * sizeof(uint32_t);
+}
+
+size_t serialize(big_integer_view a, unsigned char *out) {
+    unsigned char *p = out;
+    size_t n = a.size();
+    for (; n >= 0x80; n >>= 7)
+        *p++ = (unsigned char)(n | 0x80);
+    *p++ = (unsigned char)n;
+    if (LITTLE_ENDIAN_LIMBS) {
+        std::memcpy(p, a.data(), a.size() * sizeof(uint32_t));
+        p += a.size() * sizeof(uint32_t);
+    }
+    else
+        for (size_t i = 0; i < a.size(); ++i)
+            for (int j = 0; j < 32; j += 8)
+                *p++ = (unsigned char)(a.data()[i] >> j);
+    return p - out;
+}
+
+void serialize(big_integer_view a, std::vector<unsigned char> &out) {
+    size_t old = out.size();
+    out.resize(old + serialized_size(a));
+    serialize(a, out.data() + old);
+}
+
+//reads the limb count, returns the header length or 0 if the header is broken or the limbs don't fit into len
+static size_t read_header(const unsigned char *in, size_t len, size_t &n) {
+    n = 0;
+    size_t i = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (i == len || shift >= (int)sizeof(size_t) * 8)
+            return 0;
+        unsigned char c = in[i++];
+        n |= (size_t)(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            break;
+    }
+    if (n == 0 || n > (len - i) / sizeof(uint32_t))
+        return 0;
+    return i;
+}
+
+size_t deserialize(const unsigned char *in, size_t len, big_integer &a) {
+    size_t n, header = read_header(in, len, n);
+    if (header == 0)
+        return 0;
+    const unsigned char *p = in + header;
+    big_integer r;
+    r.resize(n);
+    if (LITTLE_ENDIAN_LIMBS)
+        std::memcpy(r.data, p, n * sizeof(uint32_t));
+    else
+        for (size_t i = 0; i < n; ++i, p += 4)
+            r.data[i] = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+    r.normalize();
+    a = std::move(r);
+    return header + n * sizeof(uint32_t);
+}
+
+size_t deserialize(const unsigned char *in, size_t len, big_integer_view &a) {
+    size_t n, header = read_header(in, len, n);
+    if (header == 0 || !LITTLE_ENDIAN_LIMBS || (uintptr_t)(in + header) % alignof(uint32_t) != 0)
+        return 0;
+    a = big_integer_view(reinterpret_cast<const uint32_t *>(in + header), n);
+    return header + n * sizeof(uint32_t);
 }
 
 void big_integer::resize(size_t nsize) {
+    //delete[] doesn't care about the size, so shrinking never has to reallocate, except to stop borrowing zero_limb
+    if (nsize <= size && owns_data()) {
+        size = nsize;
+        return;
+    }
     uint32_t * ndata = new uint32_t[nsize];
     std::copy(data, data + std::min(size, nsize), ndata);
     if (nsize > size)
         std::fill(ndata + size, ndata + nsize, filler(data[size - 1]));
-    delete[] data;
+    release();
     size = nsize;
     data = ndata;
 }
 
 void big_integer::normalize() {
-    uint32_t fill = filler(data[size - 1]);
-    for (size_t i = size; i--; )
-        if (data[i] != fill || i == 0) {
-            if (filler(data[i]) != fill) { //this shouldn't usually happen tho..., happens only if last block was eq to fill and last but one has wrong last bit
-                resize(i + 2);
-            }
-            else {
-                resize(i + 1);
-            }
-            return;
-        }
+    const uint32_t fill = filler(data[size - 1]);
+    const size_t n = strip_fill(data, size, fill);
+    if (n == 0)
+        resize(1);
+    else if (filler(data[n - 1]) != fill) //this shouldn't usually happen tho..., happens only if last block was eq to fill and last but one has wrong last bit
+        resize(n + 1);
+    else
+        resize(n);
+}
+
+void big_integer_detail::assign_magnitude(big_integer &x, const uint32_t *a, size_t n, bool neg) {
+    n = strip(a, n);
+    x.resize(n + 1);
+    std::copy(a, a + n, x.data);
+    x.data[n] = 0;
+    if (neg)
+        negate(x.data, x.data, n + 1);
+    x.normalize();
 }
+
+const uint32_t big_integer::zero_limb = 0;
+
+big_integer_view::big_integer_view() :
+    limbs(&big_integer::zero_limb),
+    n(1) {
+}
\ No newline at end of file
@@ -1,20 +1,79 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if __cplusplus > 201703L && defined(__cpp_impl_three_way_comparison)
+#include <compare>
+#define BIGINT_THREE_WAY_COMPARISON
+#endif
+
+#if __cplusplus >= 201703L
+#include <charconv>
+using std::to_chars_result;
+using std::from_chars_result;
+#else
+//the same as the C++17 ones in <charconv>
+struct to_chars_result
+{
+    char *ptr;
+    std::errc ec;
+};
+
+struct from_chars_result
+{
+    const char *ptr;
+    std::errc ec;
+};
+#endif
+
+class big_integer;
+class thread_pool;
+
+namespace big_integer_detail
+{
+    //x = a[0, n), negated if neg, in x's own buffer when it is long enough
+    void assign_magnitude(big_integer &x, const uint32_t *a, size_t n, bool neg);
+}
+
+//read-only look at limbs owned by somebody else (a big_integer, a buffer, a mapped file), in the same layout
+//big_integer keeps them: two's complement, least significant limb first, the last limb carries the sign.
+//Doesn't have to be normalized. Must not outlive the limbs.
+class big_integer_view
+{
+public:
+    big_integer_view(); //zero
+    big_integer_view(const big_integer &a);
+    big_integer_view(const uint32_t *limbs, size_t n); //Pre: n >= 1
+
+    const uint32_t *data() const;
+    size_t size() const;
+    bool negative() const;
+
+private:
+    const uint32_t *limbs;
+    size_t n;
+};
 
 class big_integer
 {
 public:
     big_integer();
     big_integer(const big_integer &b);
+    big_integer(big_integer &&b) noexcept;
     big_integer(int b);
     big_integer(uint32_t b);
     explicit big_integer(std::string const &s);
+    explicit big_integer(big_integer_view v); //copies the limbs
 
     ~big_integer();
 
     big_integer& operator=(const big_integer &other);
+    big_integer& operator=(big_integer &&other) noexcept;
 
     big_integer& operator+=(const big_integer &rhs);
     big_integer& operator-=(const big_integer &rhs);
@@ -26,6 +85,17 @@ public:
     big_integer& operator|=(const big_integer &rhs);
     big_integer& operator^=(const big_integer &rhs);
 
+    //the same for operands that live somewhere else, nothing gets copied
+    big_integer& operator+=(big_integer_view rhs);
+    big_integer& operator-=(big_integer_view rhs);
+    big_integer& operator*=(big_integer_view rhs);
+    big_integer& operator/=(big_integer_view rhs);
+    big_integer& operator%=(big_integer_view rhs);
+
+    big_integer& operator&=(big_integer_view rhs);
+    big_integer& operator|=(big_integer_view rhs);
+    big_integer& operator^=(big_integer_view rhs);
+
     big_integer& operator<<=(int rhs);
     big_integer& operator>>=(int rhs);
 
@@ -45,26 +115,62 @@ public:
     friend bool operator>(const big_integer &a, const big_integer &b);
     friend bool operator<=(const big_integer &a, const big_integer &b);
     friend bool operator>=(const big_integer &a, const big_integer &b);
+    friend bool operator==(big_integer_view a, big_integer_view b);
+    friend int compare(big_integer_view a, big_integer_view b);
+    friend int compare(const big_integer &a, const big_integer &b);
+    friend int compare(const big_integer &a, int b);
+    friend int compare(const big_integer &a, uint32_t b);
 
     friend big_integer operator + (big_integer a, const big_integer &b);
     friend big_integer operator - (big_integer a, const big_integer &b);
     friend big_integer operator * (const big_integer &a, const big_integer &b);
+    friend big_integer operator * (big_integer_view a, big_integer_view b);
     friend big_integer operator / (big_integer a, const big_integer &b);
     friend big_integer operator % (big_integer a, const big_integer &b);
     friend big_integer operator & (big_integer a, const big_integer &b);
     friend big_integer operator | (big_integer a, const big_integer &b);
     friend big_integer operator ^ (big_integer a, const big_integer &b);
-    friend big_integer operator << (big_integer a, int b);
+    friend big_integer operator << (const big_integer &a, int b);
     friend big_integer operator >> (big_integer a, int b);
 
-    friend std::string to_string(big_integer a);
+    friend std::string to_string(const big_integer &a);
+    friend from_chars_result from_chars(const char *first, const char *last, big_integer &value, int base);
+    friend std::string to_string(big_integer_view a, int base);
+    friend big_integer from_string(const char *first, const char *last, int base);
+    friend big_integer from_string(const char *first, const char *last, int base, thread_pool &pool);
+    friend std::ostream &write_string(std::ostream &out, big_integer_view a, int base);
+    friend big_integer andnot(big_integer a, big_integer_view b);
+    friend big_integer pow(big_integer_view base, unsigned exp);
+    friend big_integer mul(big_integer_view a, big_integer_view b, thread_pool &pool);
+    friend void big_integer_detail::assign_magnitude(big_integer &x, const uint32_t *a, size_t n, bool neg);
+    friend size_t deserialize(const unsigned char *in, size_t len, big_integer &a);
+
+    friend class big_integer_view;
+
+    template <size_t N> friend class fixed_big_integer;
+    template <size_t L> friend class big_integer_literal;
 
 private:
     size_t size;
     uint32_t *data;
+    static const uint32_t zero_limb; //moved-from values point here instead of owning a limb, it is never written
+    bool owns_data() const;
+    void unshare(); //gives a moved-from value a limb of its own, anything writing into data in place calls it first
+    void release(); //delete[] data unless it is zero_limb
+    big_integer(const uint32_t *limbs, size_t n); //limbs are already normalized two's complement
+    big_integer(size_t n, uint32_t fill); //n copies of fill, not normalized
     void resize(size_t nsize);
+    void shift_left_from(const uint32_t *a, size_t n, int b); //*this = a[0, n) << b for b >= 0, a may be data
     void normalize();
-    std::pair <big_integer, big_integer> divMod(const big_integer &b);
+    bool negative() const;
+    bool small() const;
+    big_integer& add_long(big_integer_view b);
+    big_integer& sub_long(big_integer_view b);
+    static bool equal_long(big_integer_view a, big_integer_view b);
+    static int compare_long(big_integer_view a, big_integer_view b);
+    static big_integer multiply(big_integer_view a, big_integer_view b); //on the default thread pool if one is set
+    static big_integer multiply(big_integer_view a, big_integer_view b, thread_pool *pool);
+    static std::pair <big_integer, big_integer> divMod(big_integer_view a, big_integer_view b);
 };
 
 big_integer operator + (big_integer a, const big_integer &b);
@@ -75,9 +181,26 @@ big_integer operator % (big_integer a, const big_integer &b);
 big_integer operator & (big_integer a, const big_integer &b);
 big_integer operator | (big_integer a, const big_integer &b);
 big_integer operator ^ (big_integer a, const big_integer &b);
-big_integer operator << (big_integer a, int b);
+big_integer operator << (const big_integer &a, int b); //straight into a new buffer, a is never copied
 big_integer operator >> (big_integer a, int b);
 
+big_integer operator + (big_integer a, big_integer_view b);
+big_integer operator - (big_integer a, big_integer_view b);
+big_integer operator * (big_integer_view a, big_integer_view b);
+big_integer operator / (big_integer a, big_integer_view b);
+big_integer operator % (big_integer a, big_integer_view b);
+big_integer operator & (big_integer a, big_integer_view b);
+big_integer operator | (big_integer a, big_integer_view b);
+big_integer operator ^ (big_integer a, big_integer_view b);
+//a & ~b without building ~b
+big_integer andnot(big_integer a, big_integer_view b);
+big_integer andnot(big_integer a, const big_integer &b);
+
+//base^exp, with the result sized from the bit lengths up front and squarings done by the squaring kernel. The factors
+//of two of base turn into a shift, a one-limb base is folded into the biggest power of it that fits into a limb
+big_integer pow(big_integer_view base, unsigned exp);
+big_integer pow(const big_integer &base, unsigned exp);
+
 bool operator == (const big_integer &a, const big_integer &b);
 bool operator != (const big_integer &a, const big_integer &b);
 bool operator < (const big_integer &a, const big_integer &b);
@@ -85,6 +208,528 @@ bool operator > (const big_integer &a, const big_integer &b);
 bool operator <= (const big_integer &a, const big_integer &b);
 bool operator >= (const big_integer &a, const big_integer &b);
 
-std::string to_string(big_integer a);
+bool operator == (big_integer_view a, big_integer_view b);
+bool operator != (big_integer_view a, big_integer_view b);
+bool operator < (big_integer_view a, big_integer_view b);
+bool operator > (big_integer_view a, big_integer_view b);
+bool operator <= (big_integer_view a, big_integer_view b);
+bool operator >= (big_integer_view a, big_integer_view b);
+
+//-1, 0 or 1 as a is less than, equal to or greater than b, in one scan from the top. Two big_integers are normalized,
+//so with the same sign the longer one is further from zero and that is settled without looking at the limbs
+int compare(big_integer_view a, big_integer_view b);
+int compare(const big_integer &a, const big_integer &b);
+
+//against a single word without making a big_integer out of it first
+int compare(const big_integer &a, int b);
+int compare(const big_integer &a, uint32_t b);
+bool operator == (const big_integer &a, int b);
+bool operator != (const big_integer &a, int b);
+bool operator < (const big_integer &a, int b);
+bool operator > (const big_integer &a, int b);
+bool operator <= (const big_integer &a, int b);
+bool operator >= (const big_integer &a, int b);
+bool operator == (int a, const big_integer &b);
+bool operator != (int a, const big_integer &b);
+bool operator < (int a, const big_integer &b);
+bool operator > (int a, const big_integer &b);
+bool operator <= (int a, const big_integer &b);
+bool operator >= (int a, const big_integer &b);
+bool operator == (const big_integer &a, uint32_t b);
+bool operator != (const big_integer &a, uint32_t b);
+bool operator < (const big_integer &a, uint32_t b);
+bool operator > (const big_integer &a, uint32_t b);
+bool operator <= (const big_integer &a, uint32_t b);
+bool operator >= (const big_integer &a, uint32_t b);
+bool operator == (uint32_t a, const big_integer &b);
+bool operator != (uint32_t a, const big_integer &b);
+bool operator < (uint32_t a, const big_integer &b);
+bool operator > (uint32_t a, const big_integer &b);
+bool operator <= (uint32_t a, const big_integer &b);
+bool operator >= (uint32_t a, const big_integer &b);
+
+#ifdef BIGINT_THREE_WAY_COMPARISON
+std::strong_ordering operator <=> (big_integer_view a, big_integer_view b);
+std::strong_ordering operator <=> (const big_integer &a, const big_integer &b);
+std::strong_ordering operator <=> (const big_integer &a, int b);
+std::strong_ordering operator <=> (const big_integer &a, uint32_t b);
+#endif
+
+std::string to_string(const big_integer &a);
+//any base from 2 to 36 with a minus sign for negative values, linear time for the powers of two. Other bases are
+//asserted against. from_string takes an optional sign and then nothing but digits of the base, anything else in
+//there is undefined behaviour; from_chars is the one that checks its input.
+std::string to_string(big_integer_view a, int base);
+big_integer from_string(const std::string &s, int base);
+big_integer from_string(const char *first, const char *last, int base);
+//to_string straight into out, the digits go out in pieces as they are found instead of in one string
+std::ostream &write_string(std::ostream &out, big_integer_view a, int base);
+
+//std::to_chars / std::from_chars for big numbers: no whitespace, no plus sign, no base prefix, and no memory
+//allocated for numbers up to a few thousand digits. On errors to_chars returns {last, value_too_large} and
+//from_chars {first, invalid_argument} leaving value as it was. A base outside [2, 36] gives {first, invalid_argument}
+//from both.
+to_chars_result to_chars(char *first, char *last, big_integer_view a, int base = 10);
+from_chars_result from_chars(const char *first, const char *last, big_integer &value, int base = 10);
+//an upper bound on what to_chars writes, sign included; cheap, doesn't look at the limbs
+size_t to_chars_size(big_integer_view a, int base = 10);
+
+//binary format: LEB128 varint with the limb count, then the limbs in little-endian two's complement, sign extended
+//just like in memory. On little-endian machines both directions are a single memcpy of the limbs.
+size_t serialized_size(big_integer_view a);
+size_t serialize(big_integer_view a, unsigned char *out); //writes serialized_size(a) bytes and returns that
+void serialize(big_integer_view a, std::vector<unsigned char> &out); //appends to out
+//both return how many bytes were consumed, 0 if in doesn't start with a valid value
+size_t deserialize(const unsigned char *in, size_t len, big_integer &a);
+//zero-copy, a points into in afterwards; works only on little-endian machines with the limbs 4-byte aligned in memory
+size_t deserialize(const unsigned char *in, size_t len, big_integer_view &a);
+
+//follow std::hex / std::oct / std::dec, std::showbase, std::uppercase and std::showpos
 std::istream & operator >> (std::istream &in, big_integer &a);
-std::ostream & operator << (std::ostream & out, const big_integer & a);
\ No newline at end of file
+std::ostream & operator << (std::ostream & out, const big_integer & a);
+
+//everything below is small enough to be inlined into the caller, the heavy loops stay in big_integer.cpp
+
+inline big_integer_view::big_integer_view(const big_integer &a) :
+    limbs(a.data),
+    n(a.size) {
+}
+
+inline big_integer_view::big_integer_view(const uint32_t *limbs, size_t n) :
+    limbs(limbs),
+    n(n) {
+}
+
+inline const uint32_t *big_integer_view::data() const {
+    return limbs;
+}
+
+inline size_t big_integer_view::size() const {
+    return n;
+}
+
+inline bool big_integer_view::negative() const {
+    return limbs[n - 1] >> 31;
+}
+
+inline big_integer::big_integer() :
+    big_integer(0) {
+}
+
+inline big_integer::big_integer(big_integer &&b) noexcept :
+    size(b.size),
+    data(b.data)
+{
+    //leave b as a valid zero without allocating: it borrows zero_limb until something writes into it
+    b.size = 1;
+    b.data = const_cast<uint32_t *>(&zero_limb);
+}
+
+inline big_integer::big_integer(int b) :
+    data(new uint32_t[1])
+{
+    size = 1; //after the new, so the compiler doesn't lose track of it across the call
+    data[0] = b;
+}
+
+inline big_integer &big_integer::operator = (big_integer &&b) noexcept {
+    std::swap(size, b.size);
+    std::swap(data, b.data);
+    return *this;
+}
+
+inline bool big_integer::negative() const {
+    return data[size - 1] >> 31;
+}
+
+inline bool big_integer::small() const { //fits into one limb, i.e. into int32_t
+    return size == 1;
+}
+
+inline bool big_integer::owns_data() const {
+    return data != &zero_limb;
+}
+
+inline void big_integer::unshare() {
+    if (!owns_data()) {
+        data = new uint32_t[1];
+        data[0] = 0;
+    }
+}
+
+inline void big_integer::release() {
+    if (owns_data())
+        delete[] data;
+}
+
+inline big_integer &big_integer::operator += (big_integer_view b) {
+    if (small() && b.size() == 1) {
+        int64_t sum = (int64_t)(int32_t)data[0] + (int32_t)b.data()[0];
+        if (sum == (int32_t)sum) {
+            unshare();
+            data[0] = (uint32_t)sum;
+            return *this;
+        }
+    }
+    return add_long(b);
+}
+
+inline big_integer &big_integer::operator -= (big_integer_view b) {
+    if (small() && b.size() == 1) {
+        int64_t diff = (int64_t)(int32_t)data[0] - (int32_t)b.data()[0];
+        if (diff == (int32_t)diff) {
+            unshare();
+            data[0] = (uint32_t)diff;
+            return *this;
+        }
+    }
+    return sub_long(b);
+}
+
+inline big_integer &big_integer::operator *= (big_integer_view b) {
+    return *this = multiply(*this, b);
+}
+
+inline big_integer &big_integer::operator /= (big_integer_view b) {
+    return *this = std::move(divMod(*this, b).first);
+}
+
+inline big_integer &big_integer::operator %= (big_integer_view b) {
+    return *this = std::move(divMod(*this, b).second);
+}
+
+inline big_integer &big_integer::operator += (const big_integer &b) {
+    return *this += big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator -= (const big_integer &b) {
+    return *this -= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator *= (const big_integer &b) {
+    return *this *= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator /= (const big_integer &b) {
+    return *this /= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator %= (const big_integer &b) {
+    return *this %= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator &= (const big_integer &b) {
+    return *this &= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator |= (const big_integer &b) {
+    return *this |= big_integer_view(b);
+}
+
+inline big_integer &big_integer::operator ^= (const big_integer &b) {
+    return *this ^= big_integer_view(b);
+}
+
+inline big_integer big_integer::operator + () const {
+    return *this;
+}
+
+inline big_integer &big_integer::operator ++ () {
+    return *this += 1;
+}
+
+inline big_integer &big_integer::operator -- () {
+    return *this -= 1;
+}
+
+inline big_integer big_integer::operator ++ (int) {
+    big_integer a = *this;
+    ++*this;
+    return a;
+}
+
+inline big_integer big_integer::operator -- (int) {
+    big_integer a = *this;
+    --*this;
+    return a;
+}
+
+inline big_integer operator + (big_integer a, big_integer_view b) {
+    a += b;
+    return a;
+}
+
+inline big_integer operator - (big_integer a, big_integer_view b) {
+    a -= b;
+    return a;
+}
+
+inline big_integer operator * (big_integer_view a, big_integer_view b) {
+    return big_integer::multiply(a, b);
+}
+
+inline big_integer operator / (big_integer a, big_integer_view b) {
+    a /= b;
+    return a;
+}
+
+inline big_integer operator % (big_integer a, big_integer_view b) {
+    a %= b;
+    return a;
+}
+
+inline big_integer operator & (big_integer a, big_integer_view b) {
+    a &= b;
+    return a;
+}
+
+inline big_integer operator | (big_integer a, big_integer_view b) {
+    a |= b;
+    return a;
+}
+
+inline big_integer operator ^ (big_integer a, big_integer_view b) {
+    a ^= b;
+    return a;
+}
+
+inline big_integer andnot(big_integer a, const big_integer &b) {
+    return andnot(std::move(a), big_integer_view(b));
+}
+
+inline big_integer operator + (big_integer a, const big_integer &b) {
+    return std::move(a) + big_integer_view(b);
+}
+
+inline big_integer operator - (big_integer a, const big_integer &b) {
+    return std::move(a) - big_integer_view(b);
+}
+
+inline big_integer operator * (const big_integer &a, const big_integer &b) {
+    return big_integer::multiply(a, b);
+}
+
+inline big_integer operator / (big_integer a, const big_integer &b) {
+    return std::move(a) / big_integer_view(b);
+}
+
+inline big_integer operator % (big_integer a, const big_integer &b) {
+    return std::move(a) % big_integer_view(b);
+}
+
+inline big_integer operator & (big_integer a, const big_integer &b) {
+    return std::move(a) & big_integer_view(b);
+}
+
+inline big_integer operator | (big_integer a, const big_integer &b) {
+    return std::move(a) | big_integer_view(b);
+}
+
+inline big_integer operator ^ (big_integer a, const big_integer &b) {
+    return std::move(a) ^ big_integer_view(b);
+}
+
+inline big_integer operator >> (big_integer a, int b) {
+    a >>= b;
+    return a;
+}
+
+inline big_integer pow(const big_integer &base, unsigned exp) {
+    return pow(big_integer_view(base), exp);
+}
+
+inline int compare(big_integer_view a, big_integer_view b) {
+    if (a.size() == 1 && b.size() == 1) {
+        int32_t x = (int32_t)a.data()[0], y = (int32_t)b.data()[0];
+        return (x > y) - (x < y);
+    }
+    return big_integer::compare_long(a, b);
+}
+
+inline int compare(const big_integer &a, const big_integer &b) {
+    if (a.size != b.size && a.negative() == b.negative())
+        return (a.size < b.size) != a.negative() ? -1 : 1;
+    return compare(big_integer_view(a), big_integer_view(b));
+}
+
+inline int compare(const big_integer &a, int b) {
+    if (!a.small()) //doesn't fit into int32_t, so the sign alone decides
+        return a.negative() ? -1 : 1;
+    int32_t x = (int32_t)a.data[0];
+    return (x > b) - (x < b);
+}
+
+inline int compare(const big_integer &a, uint32_t b) {
+    if (b >> 31 == 0)
+        return compare(a, (int)b);
+    if (a.negative() || a.size == 1) //anything in one limb is below 2^31
+        return -1;
+    if (a.size > 2 || a.data[1] != 0)
+        return 1;
+    return (a.data[0] > b) - (a.data[0] < b);
+}
+
+inline bool operator == (big_integer_view a, big_integer_view b) {
+    if (a.size() == 1 && b.size() == 1)
+        return a.data()[0] == b.data()[0];
+    return big_integer::equal_long(a, b);
+}
+
+inline bool operator != (big_integer_view a, big_integer_view b) {
+    return !(a == b);
+}
+
+inline bool operator < (big_integer_view a, big_integer_view b) {
+    return compare(a, b) < 0;
+}
+
+inline bool operator > (big_integer_view a, big_integer_view b) {
+    return compare(a, b) > 0;
+}
+
+inline bool operator <= (big_integer_view a, big_integer_view b) {
+    return compare(a, b) <= 0;
+}
+
+inline bool operator >= (big_integer_view a, big_integer_view b) {
+    return compare(a, b) >= 0;
+}
+
+inline bool operator == (const big_integer &a, const big_integer &b) {
+    return a.size == b.size && big_integer_view(a) == big_integer_view(b);
+}
+
+inline bool operator != (const big_integer &a, const big_integer &b) {
+    return !(a == b);
+}
+
+inline bool operator < (const big_integer &a, const big_integer &b) {
+    return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, const big_integer &b) {
+    return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, const big_integer &b) {
+    return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, const big_integer &b) {
+    return compare(a, b) >= 0;
+}
+
+inline bool operator == (const big_integer &a, int b) {
+    return compare(a, b) == 0;
+}
+
+inline bool operator != (const big_integer &a, int b) {
+    return compare(a, b) != 0;
+}
+
+inline bool operator < (const big_integer &a, int b) {
+    return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, int b) {
+    return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, int b) {
+    return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, int b) {
+    return compare(a, b) >= 0;
+}
+
+inline bool operator == (int a, const big_integer &b) {
+    return compare(b, a) == 0;
+}
+
+inline bool operator != (int a, const big_integer &b) {
+    return compare(b, a) != 0;
+}
+
+inline bool operator < (int a, const big_integer &b) {
+    return compare(b, a) > 0;
+}
+
+inline bool operator > (int a, const big_integer &b) {
+    return compare(b, a) < 0;
+}
+
+inline bool operator <= (int a, const big_integer &b) {
+    return compare(b, a) >= 0;
+}
+
+inline bool operator >= (int a, const big_integer &b) {
+    return compare(b, a) <= 0;
+}
+
+inline bool operator == (const big_integer &a, uint32_t b) {
+    return compare(a, b) == 0;
+}
+
+inline bool operator != (const big_integer &a, uint32_t b) {
+    return compare(a, b) != 0;
+}
+
+inline bool operator < (const big_integer &a, uint32_t b) {
+    return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, uint32_t b) {
+    return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, uint32_t b) {
+    return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, uint32_t b) {
+    return compare(a, b) >= 0;
+}
+
+inline bool operator == (uint32_t a, const big_integer &b) {
+    return compare(b, a) == 0;
+}
+
+inline bool operator != (uint32_t a, const big_integer &b) {
+    return compare(b, a) != 0;
+}
+
+inline bool operator < (uint32_t a, const big_integer &b) {
+    return compare(b, a) > 0;
+}
+
+inline bool operator > (uint32_t a, const big_integer &b) {
+    return compare(b, a) < 0;
+}
+
+inline bool operator <= (uint32_t a, const big_integer &b) {
+    return compare(b, a) >= 0;
+}
+
+inline bool operator >= (uint32_t a, const big_integer &b) {
+    return compare(b, a) <= 0;
+}
+
+
+#ifdef BIGINT_THREE_WAY_COMPARISON
+inline std::strong_ordering operator <=> (big_integer_view a, big_integer_view b) {
+    return compare(a, b) <=> 0;
+}
+
+inline std::strong_ordering operator <=> (const big_integer &a, const big_integer &b) {
+    return compare(a, b) <=> 0;
+}
+
+inline std::strong_ordering operator <=> (const big_integer &a, int b) {
+    return compare(a, b) <=> 0;
+}
+
+inline std::strong_ordering operator <=> (const big_integer &a, uint32_t b) {
+    return compare(a, b) <=> 0;
+}
+#endif
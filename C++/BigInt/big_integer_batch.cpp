@@ -0,0 +1,114 @@
+#include "big_integer_batch.h"
+#include "big_integer_magnitude.h"
+#include "big_integer_modular.h"
+#include <algorithm>
+#include <numeric>
+
+using namespace big_integer_detail;
+
+namespace
+{
+    //|a| with its length, pointing into a unless it has to be negated into arena
+    const uint32_t *load(big_integer_view a, uint32_t *arena, size_t &n) {
+        const uint32_t *p = a.data();
+        if (a.negative()) {
+            negate(arena, p, a.size());
+            p = arena;
+        }
+        n = strip(p, a.size());
+        return p;
+    }
+
+    //how many pieces a batch is cut into per thread, so that an unlucky piece doesn't hold everybody up
+    const size_t PIECES_PER_THREAD = 8;
+
+    //op(i, arena) for every i, where arena has room for arena_size(i) limbs. The biggest items go first and the
+    //sorted order is cut into runs of about equal cost, one task each
+    template <class Size, class Op>
+    void run_batch(const big_integer *a, const big_integer *b, size_t n, thread_pool *pool, Size arena_size, Op op) {
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        auto cost = [&](size_t i) {
+            return (double)big_integer_view(a[i]).size() * big_integer_view(b[i]).size();
+        };
+        std::sort(order.begin(), order.end(), [&](size_t x, size_t y) { return cost(x) > cost(y); });
+        double total = 0;
+        for (size_t i = 0; i < n; ++i)
+            total += cost(i);
+        const double target = total / (PIECES_PER_THREAD * (pool ? pool->threads() : 1));
+        std::vector<size_t> begin(1, 0);
+        double acc = 0;
+        for (size_t k = 0; k < n; ++k) {
+            acc += cost(order[k]);
+            if (acc >= target && k + 1 < n) {
+                begin.push_back(k + 1);
+                acc = 0;
+            }
+        }
+        begin.push_back(n);
+        auto piece = [&](size_t t) {
+            size_t size = 0;
+            for (size_t k = begin[t]; k < begin[t + 1]; ++k)
+                size = std::max(size, arena_size(order[k]));
+            std::vector<uint32_t> arena(size);
+            for (size_t k = begin[t]; k < begin[t + 1]; ++k)
+                op(order[k], arena.data());
+        };
+        if (pool)
+            pool->parallel_for(begin.size() - 1, piece);
+        else
+            for (size_t t = 0; t + 1 < begin.size(); ++t)
+                piece(t);
+    }
+
+    void mul_on(const big_integer *a, const big_integer *b, big_integer *out, size_t n, thread_pool *pool) {
+        auto arena_size = [&](size_t i) {
+            const size_t an = big_integer_view(a[i]).size(), bn = big_integer_view(b[i]).size();
+            return 2 * (an + bn);
+        };
+        run_batch(a, b, n, pool, arena_size, [&](size_t i, uint32_t *arena) {
+            big_integer_view x = a[i], y = b[i];
+            size_t xn, yn;
+            const uint32_t *xm = load(x, arena, xn), *ym = load(y, arena + x.size(), yn);
+            uint32_t *r = arena + x.size() + y.size();
+            mul_basecase(r, xm, xn, ym, yn);
+            assign_magnitude(out[i], r, xn + yn, x.negative() != y.negative());
+        });
+    }
+
+    void mulmod_on(const big_integer *a, const big_integer *b, big_integer_view m, big_integer *out, size_t n,
+                   thread_pool *pool) {
+        const barrett_reducer red(m.negative() ? big_integer_view(-big_integer(m)) : m);
+        const size_t k = red.size();
+        auto arena_size = [&](size_t i) {
+            const size_t an = big_integer_view(a[i]).size(), bn = big_integer_view(b[i]).size();
+            return 2 * (an + bn) + k + red.scratch_size();
+        };
+        run_batch(a, b, n, pool, arena_size, [&](size_t i, uint32_t *arena) {
+            big_integer_view x = a[i], y = b[i];
+            size_t xn, yn;
+            const uint32_t *xm = load(x, arena, xn), *ym = load(y, arena + x.size(), yn);
+            uint32_t *p = arena + x.size() + y.size(), *r = p + x.size() + y.size();
+            mul_basecase(p, xm, xn, ym, yn);
+            red.reduce(r, p, xn + yn, r + k);
+            assign_magnitude(out[i], r, k, x.negative() != y.negative());
+        });
+    }
+}
+
+void batch_mul(const big_integer *a, const big_integer *b, big_integer *out, size_t n) {
+    mul_on(a, b, out, n, default_thread_pool());
+}
+
+void batch_mul(const big_integer *a, const big_integer *b, big_integer *out, size_t n, thread_pool &pool) {
+    mul_on(a, b, out, n, &pool);
+}
+
+void batch_mulmod(const big_integer *a, const big_integer *b, big_integer_view m, big_integer *out, size_t n) {
+    mulmod_on(a, b, m, out, n, default_thread_pool());
+}
+
+void batch_mulmod(const big_integer *a, const big_integer *b, big_integer_view m, big_integer *out, size_t n,
+                  thread_pool &pool) {
+    mulmod_on(a, b, m, out, n, &pool);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "big_integer.h"
+#include "big_integer_parallel.h"
+
+//The same operation on many independent operands at once, out[i] = op(a[i], b[i]) for i < n. The work is sorted
+//by size and cut into pieces of about equal cost, every piece reuses one scratch arena for all of its operands and
+//the results are written into the buffers out already has. Without a pool the default one is used if there is one.
+//out must not overlap the inputs.
+
+void batch_mul(const big_integer *a, const big_integer *b, big_integer *out, size_t n);
+void batch_mul(const big_integer *a, const big_integer *b, big_integer *out, size_t n, thread_pool &pool);
+
+//out[i] = a[i] * b[i] % m, with the sign rules of operator%. Pre: m != 0
+void batch_mulmod(const big_integer *a, const big_integer *b, big_integer_view m, big_integer *out, size_t n);
+void batch_mulmod(const big_integer *a, const big_integer *b, big_integer_view m, big_integer *out, size_t n,
+                  thread_pool &pool);
@@ -0,0 +1,134 @@
+#include "big_integer_file.h"
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BIG_INTEGER_MMAP
+#endif
+
+namespace
+{
+    //the whole file as one read-only range; mapped where the platform allows it, read into memory otherwise
+    class file_contents
+    {
+    public:
+        explicit file_contents(const char *path);
+        ~file_contents();
+        file_contents(const file_contents &) = delete;
+        file_contents &operator=(const file_contents &) = delete;
+
+        bool ok() const;
+        const char *begin() const;
+        const char *end() const;
+
+    private:
+        const char *first;
+        size_t len;
+        bool good;
+        bool mapped;
+        std::vector<char> copy;
+        bool read_copy(const char *path);
+    };
+
+    file_contents::file_contents(const char *path) :
+        first(nullptr),
+        len(0),
+        good(false),
+        mapped(false)
+    {
+#ifdef BIG_INTEGER_MMAP
+        int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            len = (size_t)st.st_size;
+            good = true;
+            if (len > 0) {
+                void *p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, len, MADV_SEQUENTIAL); //the digits are read front to back exactly once
+                    first = static_cast<const char *>(p);
+                    mapped = true;
+                }
+                else
+                    good = read_copy(path);
+            }
+        }
+        else
+            good = read_copy(path); //pipes and the like
+        close(fd);
+#else
+        good = read_copy(path);
+#endif
+    }
+
+    file_contents::~file_contents() {
+#ifdef BIG_INTEGER_MMAP
+        if (mapped)
+            munmap(const_cast<char *>(first), len);
+#endif
+    }
+
+    bool file_contents::read_copy(const char *path) {
+        std::ifstream in(path, std::ios_base::binary);
+        if (!in)
+            return false;
+        copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        first = copy.data();
+        len = copy.size();
+        return !in.bad();
+    }
+
+    bool file_contents::ok() const {
+        return good;
+    }
+
+    const char *file_contents::begin() const {
+        return first;
+    }
+
+    const char *file_contents::end() const {
+        return first + len;
+    }
+
+    bool is_space(char c) {
+        return std::isspace((unsigned char)c) != 0;
+    }
+}
+
+bool read_decimal_file(const char *path, big_integer &a) {
+    file_contents f(path);
+    if (!f.ok())
+        return false;
+    const char *first = f.begin(), *last = f.end();
+    while (first != last && is_space(*first))
+        ++first;
+    while (last != first && is_space(last[-1]))
+        --last;
+    const char *digits = first;
+    if (digits != last && (*digits == '-' || *digits == '+'))
+        ++digits;
+    if (digits == last)
+        return false;
+    for (const char *p = digits; p != last; ++p)
+        if (*p < '0' || *p > '9')
+            return false;
+    a = from_string(first, last, 10);
+    return true;
+}
+
+bool write_decimal_file(const char *path, big_integer_view a) {
+    std::ofstream out(path, std::ios_base::binary | std::ios_base::trunc);
+    if (!out)
+        return false;
+    write_string(out, a, 10) << '\n';
+    out.close();
+    return !out.fail();
+}
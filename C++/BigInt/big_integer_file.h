@@ -0,0 +1,12 @@
+#pragma once
+
+#include "big_integer.h"
+
+//decimal numbers that are too big to go through a std::string: hundreds of megabytes of digits.
+//The input file is mapped into memory and parsed in place, the output goes out in pieces as it is converted.
+
+//one decimal number with an optional sign, whitespace around it is skipped.
+//false if the file can't be read or doesn't hold a number, a is left alone then
+bool read_decimal_file(const char *path, big_integer &a);
+//false on I/O errors
+bool write_decimal_file(const char *path, big_integer_view a);
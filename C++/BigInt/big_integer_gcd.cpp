@@ -0,0 +1,166 @@
+#include "big_integer_gcd.h"
+#include "big_integer_magnitude.h"
+#include <algorithm>
+#include <vector>
+
+using namespace big_integer_detail;
+
+namespace
+{
+    const int64_t COFACTOR_LIMIT = INT32_MAX; //cofactors stay in an int, so they are single limbs
+
+    uint64_t binary_gcd(uint64_t a, uint64_t b) {
+        if (a == 0 || b == 0)
+            return a | b;
+        int shift = trailing_zeros(a | b);
+        a >>= trailing_zeros(a);
+        while (b != 0) {
+            b >>= trailing_zeros(b);
+            if (a > b)
+                std::swap(a, b);
+            b -= a;
+        }
+        return a << shift;
+    }
+
+    //floor(a / 2^shift) mod 2^64
+    uint64_t bits_from(const uint32_t *a, size_t n, size_t shift) {
+        size_t limb = shift / 32, off = shift % 32;
+        uint64_t lo = limb < n ? a[limb] : 0, mid = limb + 1 < n ? a[limb + 1] : 0, hi = limb + 2 < n ? a[limb + 2] : 0;
+        uint64_t r = (lo | mid << 32) >> off;
+        if (off)
+            r |= hi << (64 - off);
+        return r;
+    }
+
+    //r = p * x + q * y for p, q of opposite signs (or zero) when the result is known to be non-negative and to fit
+    //into n limbs
+    void combine(uint32_t *r, const uint32_t *x, int64_t p, const uint32_t *y, int64_t q, size_t n) {
+        if (q <= 0) {
+            mul_1(r, x, n, (uint32_t)p);
+            submul_1(r, y, n, (uint32_t)-q);
+        }
+        else {
+            mul_1(r, y, n, (uint32_t)q);
+            submul_1(r, x, n, (uint32_t)-p);
+        }
+    }
+
+    //Euclid on the leading bits: returns the matrix (A B; C D) such that (A a + B b, C a + D b) are two consecutive
+    //remainders of the full a and b, with every entry within COFACTOR_LIMIT. B = 0 means not a single step was sure.
+    //Knuth's Algorithm L, x and y are a and b both shifted right by the same amount
+    void lehmer_matrix(int64_t x, int64_t y, int64_t &A, int64_t &B, int64_t &C, int64_t &D) {
+        A = 1, B = 0, C = 0, D = 1;
+        for (;;) {
+            int64_t yc = y + C, yd = y + D;
+            if (yc <= 0 || yd <= 0)
+                break;
+            int64_t q = (x + A) / yc;
+            if (q != (x + B) / yd || q > COFACTOR_LIMIT)
+                break;
+            int64_t nc = A - q * C, nd = B - q * D;
+            if (nc > COFACTOR_LIMIT || nc < -COFACTOR_LIMIT || nd > COFACTOR_LIMIT || nd < -COFACTOR_LIMIT)
+                break;
+            A = C;
+            B = D;
+            C = nc;
+            D = nd;
+            int64_t t = x - q * y;
+            x = y;
+            y = t;
+        }
+    }
+
+    //Runs Euclid on the magnitudes a >= b until b is 0 or, without cofactors, until both fit into 64 bits. With s0 and
+    //s1 it keeps a = s0 * a0 and b = s1 * a0 modulo the original b0 along the way.
+    void lehmer(std::vector<uint32_t> &a, std::vector<uint32_t> &b, big_integer *s0, big_integer *s1) {
+        size_t n = strip(a.data(), a.size());
+        b.resize(n);
+        std::vector<uint32_t> ta(n), tb(n), q;
+        for (;;) {
+            n = strip(a.data(), n);
+            size_t bn = strip(b.data(), n);
+            if (bn == 0 || (!s0 && n <= 2))
+                break;
+            size_t bits = bit_length(a.data(), n), shift = bits > 62 ? bits - 62 : 0;
+            int64_t A, B, C, D;
+            lehmer_matrix((int64_t)bits_from(a.data(), n, shift), (int64_t)bits_from(b.data(), n, shift), A, B, C, D);
+            if (B == 0) {
+                //the quotient is too big for the leading bits to tell anything: one real division step
+                q.resize(n - bn + 1);
+                divrem(q.data(), tb.data(), a.data(), n, b.data(), bn);
+                std::fill(tb.begin() + bn, tb.begin() + n, 0);
+                a.swap(b);
+                b.swap(tb);
+                if (s0) {
+                    big_integer t = *s0 - from_magnitude(q.data(), q.size()) * *s1;
+                    *s0 = std::move(*s1);
+                    *s1 = std::move(t);
+                }
+                continue;
+            }
+            combine(ta.data(), a.data(), A, b.data(), B, n);
+            combine(tb.data(), a.data(), C, b.data(), D, n);
+            a.swap(ta);
+            b.swap(tb);
+            if (s0) {
+                big_integer t0 = *s0 * (int)A + *s1 * (int)B;
+                *s1 = *s0 * (int)C + *s1 * (int)D;
+                *s0 = std::move(t0);
+            }
+        }
+        a.resize(n);
+        b.resize(strip(b.data(), n));
+    }
+
+    //the one that Lehmer's loop starts with has to be the bigger one
+    bool less(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+        return cmp(a.data(), a.size(), b.data(), b.size()) < 0;
+    }
+}
+
+big_integer gcd(big_integer_view a, big_integer_view b) {
+    std::vector<uint32_t> x, y;
+    magnitude(a, x);
+    magnitude(b, y);
+    if (less(x, y))
+        x.swap(y);
+    if (y.empty())
+        return from_magnitude(x.data(), x.size());
+    lehmer(x, y, nullptr, nullptr);
+    if (!y.empty()) {
+        uint64_t g = binary_gcd(to_64(x.data(), x.size()), to_64(y.data(), y.size()));
+        return from_64(g);
+    }
+    return from_magnitude(x.data(), x.size());
+}
+
+big_integer lcm(big_integer_view a, big_integer_view b) {
+    big_integer g = gcd(a, b);
+    if (g == 0)
+        return 0;
+    big_integer r = big_integer(a) / g * b;
+    return r < 0 ? -r : r;
+}
+
+big_integer gcdext(big_integer_view a, big_integer_view b, big_integer &x, big_integer &y) {
+    std::vector<uint32_t> u, v;
+    magnitude(a, u);
+    magnitude(b, v);
+    bool swapped = less(u, v);
+    if (swapped)
+        u.swap(v);
+    //now u = |a| and v = |b| or the other way round, u >= v
+    big_integer su = from_magnitude(u.data(), u.size()), sv = from_magnitude(v.data(), v.size());
+    big_integer s0 = 1, s1 = 0;
+    if (!v.empty())
+        lehmer(u, v, &s0, &s1);
+    big_integer g = from_magnitude(u.data(), u.size());
+    //g = s0 * su + t * sv
+    big_integer t = sv == 0 ? big_integer(0) : (g - s0 * su) / sv;
+    if (swapped)
+        std::swap(s0, t);
+    x = a.negative() ? -s0 : s0;
+    y = b.negative() ? -t : t;
+    return g;
+}
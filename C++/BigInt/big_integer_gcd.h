@@ -0,0 +1,29 @@
+#pragma once
+
+#include "big_integer.h"
+
+//greatest common divisor, always non-negative; gcd(0, 0) = 0.
+//Lehmer's algorithm: while the numbers are long, Euclid runs on their leading 62 bits and the collected cofactor
+//matrix is applied to the full numbers in one linear pass; once they fit into 64 bits a binary GCD finishes.
+big_integer gcd(big_integer_view a, big_integer_view b);
+big_integer gcd(const big_integer &a, const big_integer &b);
+
+//least common multiple, non-negative; 0 if either is 0
+big_integer lcm(big_integer_view a, big_integer_view b);
+big_integer lcm(const big_integer &a, const big_integer &b);
+
+//returns g = gcd(a, b) and sets x, y such that a * x + b * y = g
+big_integer gcdext(big_integer_view a, big_integer_view b, big_integer &x, big_integer &y);
+big_integer gcdext(const big_integer &a, const big_integer &b, big_integer &x, big_integer &y);
+
+inline big_integer gcd(const big_integer &a, const big_integer &b) {
+    return gcd(big_integer_view(a), big_integer_view(b));
+}
+
+inline big_integer lcm(const big_integer &a, const big_integer &b) {
+    return lcm(big_integer_view(a), big_integer_view(b));
+}
+
+inline big_integer gcdext(const big_integer &a, const big_integer &b, big_integer &x, big_integer &y) {
+    return gcdext(big_integer_view(a), big_integer_view(b), x, y);
+}
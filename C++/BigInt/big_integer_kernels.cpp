@@ -0,0 +1,445 @@
+#include "big_integer_kernels.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIGINT_X86_DISPATCH
+#include <immintrin.h>
+#define BIGINT_AVX2 __attribute__((target("avx2")))
+#define BIGINT_AVX512 __attribute__((target("avx512f")))
+#define BIGINT_VBMI2 __attribute__((target("avx512f,avx512vbmi2")))
+#endif
+
+//The bitwise loops are written once against an operation with a word, an AVX2 and an AVX-512 version of itself
+//and compiled for every instruction set; which one runs is decided by what the processor reports at startup.
+
+namespace
+{
+    enum simd_level
+    {
+        SIMD_NONE, //whatever the compiler makes of the plain loop, SSE2 on x86-64
+        SIMD_AVX2,
+        SIMD_AVX512,
+        SIMD_VBMI2 //AVX-512 plus the funnel shifts, which only the shift kernels look at
+    };
+
+    simd_level detect_simd() {
+#ifdef BIGINT_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vbmi2"))
+            return SIMD_VBMI2;
+        if (__builtin_cpu_supports("avx512f"))
+            return SIMD_AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return SIMD_AVX2;
+#endif
+        return SIMD_NONE;
+    }
+
+    //zero (SIMD_NONE) until the initializer has run, so early callers just get the plain loops
+    const simd_level SIMD = detect_simd();
+
+    //shorter spans aren't worth leaving the plain loop for
+    const size_t SIMD_MIN_LIMBS = 16;
+
+    struct and_op
+    {
+        static uint32_t word(uint32_t x, uint32_t y) { return x & y; }
+#ifdef BIGINT_X86_DISPATCH
+        BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+        BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_and_si512(x, y); }
+#endif
+    };
+
+    struct or_op
+    {
+        static uint32_t word(uint32_t x, uint32_t y) { return x | y; }
+#ifdef BIGINT_X86_DISPATCH
+        BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+        BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_or_si512(x, y); }
+#endif
+    };
+
+    struct xor_op
+    {
+        static uint32_t word(uint32_t x, uint32_t y) { return x ^ y; }
+#ifdef BIGINT_X86_DISPATCH
+        BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+        BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+#endif
+    };
+
+    struct andnot_op
+    {
+        static uint32_t word(uint32_t x, uint32_t y) { return x & ~y; }
+#ifdef BIGINT_X86_DISPATCH
+        BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_andnot_si256(y, x); }
+        //the unmasked form passes an undefined vector through, which GCC takes for a use of an uninitialized one
+        BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_maskz_andnot_epi32(0xffff, y, x); }
+#endif
+    };
+
+    //b is either a span (step 1) or a single word broadcast over all of a (step 0)
+    template <class Op>
+    void bitwise_plain(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            r[i] = Op::word(a[i], b[i * step]);
+    }
+
+#ifdef BIGINT_X86_DISPATCH
+    template <class Op>
+    BIGINT_AVX2 void bitwise_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        const __m256i fill = _mm256_set1_epi32((int)b[0]);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i y = step ? _mm256_loadu_si256((const __m256i *)(b + i)) : fill;
+            _mm256_storeu_si256((__m256i *)(r + i), Op::avx2(x, y));
+        }
+        bitwise_plain<Op>(r + i, a + i, b + i * step, step, n - i);
+    }
+
+    template <class Op>
+    BIGINT_AVX512 void bitwise_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        const __m512i fill = _mm512_set1_epi32((int)b[0]);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + i));
+            __m512i y = step ? _mm512_loadu_si512((const void *)(b + i)) : fill;
+            _mm512_storeu_si512((void *)(r + i), Op::avx512(x, y));
+        }
+        bitwise_plain<Op>(r + i, a + i, b + i * step, step, n - i);
+    }
+#endif
+
+    //one past the highest i < n with a[i] != b[i * step], 0 if there is none; step 0 compares against a single word
+    size_t mismatch_plain(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        while (n > 0 && a[n - 1] == b[(n - 1) * step])
+            --n;
+        return n;
+    }
+
+#ifdef BIGINT_X86_DISPATCH
+    BIGINT_AVX2 size_t mismatch_avx2(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        const __m256i fill = _mm256_set1_epi32((int)b[0]);
+        for (; n >= 8; n -= 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + n - 8));
+            __m256i y = step ? _mm256_loadu_si256((const __m256i *)(b + n - 8)) : fill;
+            unsigned equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y)));
+            if (equal != 0xff)
+                return n - 8 + big_integer_detail::maxbit(~equal & 0xff) + 1;
+        }
+        return mismatch_plain(a, b, step, n);
+    }
+
+    BIGINT_AVX512 size_t mismatch_avx512(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+        const __m512i fill = _mm512_set1_epi32((int)b[0]);
+        for (; n >= 16; n -= 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + n - 16));
+            __m512i y = step ? _mm512_loadu_si512((const void *)(b + n - 16)) : fill;
+            __mmask16 differ = _mm512_cmpneq_epi32_mask(x, y);
+            if (differ)
+                return n - 16 + big_integer_detail::maxbit(differ) + 1;
+        }
+        return mismatch_plain(a, b, step, n);
+    }
+#endif
+
+    size_t mismatch(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+#ifdef BIGINT_X86_DISPATCH
+        if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+            return mismatch_avx512(a, b, step, n);
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+            return mismatch_avx2(a, b, step, n);
+#endif
+        return mismatch_plain(a, b, step, n);
+    }
+
+    //the loops go from the top down for lshift and from the bottom up for rshift, so every limb is read before
+    //anything lands on it even when r sits above (below) a
+    uint32_t lshift_plain(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = n ? a[n - 1] >> (32 - k) : 0;
+        for (size_t i = n; i-- > 1; )
+            r[i] = a[i] << k | a[i - 1] >> (32 - k);
+        if (n)
+            r[0] = a[0] << k;
+        return out;
+    }
+
+    uint32_t rshift_plain(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = n ? a[0] << (32 - k) : 0;
+        for (size_t i = 0; i + 1 < n; ++i)
+            r[i] = a[i] >> k | a[i + 1] << (32 - k);
+        if (n)
+            r[n - 1] = a[n - 1] >> k;
+        return out;
+    }
+
+#ifdef BIGINT_X86_DISPATCH
+    //without AVX-512 VBMI2 the funnel shift is two shifts and an or over a window one limb apart
+    BIGINT_AVX2 uint32_t lshift_avx2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[n - 1] >> (32 - k);
+        const __m128i up = _mm_cvtsi32_si128(k), down = _mm_cvtsi32_si128(32 - k);
+        size_t i = n;
+        for (; i >= 9; i -= 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + i - 8));
+            __m256i y = _mm256_loadu_si256((const __m256i *)(a + i - 9));
+            __m256i z = _mm256_or_si256(_mm256_sll_epi32(x, up), _mm256_srl_epi32(y, down));
+            _mm256_storeu_si256((__m256i *)(r + i - 8), z);
+        }
+        lshift_plain(r, a, i, k);
+        return out;
+    }
+
+    BIGINT_AVX2 uint32_t rshift_avx2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[0] << (32 - k);
+        const __m128i down = _mm_cvtsi32_si128(k), up = _mm_cvtsi32_si128(32 - k);
+        size_t i = 0;
+        for (; i + 9 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i y = _mm256_loadu_si256((const __m256i *)(a + i + 1));
+            __m256i z = _mm256_or_si256(_mm256_srl_epi32(x, down), _mm256_sll_epi32(y, up));
+            _mm256_storeu_si256((__m256i *)(r + i), z);
+        }
+        rshift_plain(r + i, a + i, n - i, k);
+        return out;
+    }
+
+    //the unmasked 512-bit shifts pass an undefined vector through, which -Wall reports as maybe uninitialized
+    BIGINT_AVX512 uint32_t lshift_avx512(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[n - 1] >> (32 - k);
+        const __m128i up = _mm_cvtsi32_si128(k), down = _mm_cvtsi32_si128(32 - k);
+        size_t i = n;
+        for (; i >= 17; i -= 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + i - 16));
+            __m512i y = _mm512_loadu_si512((const void *)(a + i - 17));
+            __m512i z = _mm512_or_si512(_mm512_maskz_sll_epi32(0xffff, x, up), _mm512_maskz_srl_epi32(0xffff, y, down));
+            _mm512_storeu_si512((void *)(r + i - 16), z);
+        }
+        lshift_plain(r, a, i, k);
+        return out;
+    }
+
+    BIGINT_AVX512 uint32_t rshift_avx512(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[0] << (32 - k);
+        const __m128i down = _mm_cvtsi32_si128(k), up = _mm_cvtsi32_si128(32 - k);
+        size_t i = 0;
+        for (; i + 17 <= n; i += 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + i));
+            __m512i y = _mm512_loadu_si512((const void *)(a + i + 1));
+            __m512i z = _mm512_or_si512(_mm512_maskz_srl_epi32(0xffff, x, down), _mm512_maskz_sll_epi32(0xffff, y, up));
+            _mm512_storeu_si512((void *)(r + i), z);
+        }
+        rshift_plain(r + i, a + i, n - i, k);
+        return out;
+    }
+
+    //vpshldvd and vpshrdvd are the funnel shift in one instruction
+    BIGINT_VBMI2 uint32_t lshift_vbmi2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[n - 1] >> (32 - k);
+        const __m512i count = _mm512_set1_epi32(k);
+        size_t i = n;
+        for (; i >= 17; i -= 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + i - 16));
+            __m512i y = _mm512_loadu_si512((const void *)(a + i - 17));
+            _mm512_storeu_si512((void *)(r + i - 16), _mm512_shldv_epi32(x, y, count));
+        }
+        lshift_plain(r, a, i, k);
+        return out;
+    }
+
+    BIGINT_VBMI2 uint32_t rshift_vbmi2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+        const uint32_t out = a[0] << (32 - k);
+        const __m512i count = _mm512_set1_epi32(k);
+        size_t i = 0;
+        for (; i + 17 <= n; i += 16) {
+            __m512i x = _mm512_loadu_si512((const void *)(a + i));
+            __m512i y = _mm512_loadu_si512((const void *)(a + i + 1));
+            _mm512_storeu_si512((void *)(r + i), _mm512_shrdv_epi32(x, y, count));
+        }
+        rshift_plain(r + i, a + i, n - i, k);
+        return out;
+    }
+#endif
+
+    template <class Op>
+    void bitwise(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+#ifdef BIGINT_X86_DISPATCH
+        if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+            return bitwise_avx512<Op>(r, a, b, step, n);
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+            return bitwise_avx2<Op>(r, a, b, step, n);
+#endif
+        bitwise_plain<Op>(r, a, b, step, n);
+    }
+}
+
+namespace big_integer_detail
+{
+    void and_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        bitwise<and_op>(r, a, b, 1, n);
+    }
+
+    void or_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        bitwise<or_op>(r, a, b, 1, n);
+    }
+
+    void xor_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        bitwise<xor_op>(r, a, b, 1, n);
+    }
+
+    void andnot_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        bitwise<andnot_op>(r, a, b, 1, n);
+    }
+
+    void not_n(uint32_t *r, const uint32_t *a, size_t n) {
+        const uint32_t ones = BASE;
+        bitwise<xor_op>(r, a, &ones, 0, n);
+    }
+
+    size_t strip_fill(const uint32_t *a, size_t n, uint32_t fill) {
+        return mismatch(a, &fill, 0, n);
+    }
+
+    size_t diff_length(const uint32_t *a, const uint32_t *b, size_t n) {
+        return mismatch(a, b, 1, n);
+    }
+
+    uint32_t lshift(uint32_t *r, const uint32_t *a, size_t n, int k) {
+#ifdef BIGINT_X86_DISPATCH
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_VBMI2)
+            return lshift_vbmi2(r, a, n, k);
+        if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+            return lshift_avx512(r, a, n, k);
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+            return lshift_avx2(r, a, n, k);
+#endif
+        return lshift_plain(r, a, n, k);
+    }
+
+    uint32_t rshift(uint32_t *r, const uint32_t *a, size_t n, int k) {
+#ifdef BIGINT_X86_DISPATCH
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_VBMI2)
+            return rshift_vbmi2(r, a, n, k);
+        if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+            return rshift_avx512(r, a, n, k);
+        if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+            return rshift_avx2(r, a, n, k);
+#endif
+        return rshift_plain(r, a, n, k);
+    }
+
+    void mul_basecase(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn) {
+        if (an < bn) {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        if (bn == 0) {
+            std::fill(r, r + an, 0);
+            return;
+        }
+        r[an] = mul_1(r, a, an, b[0]);
+        for (size_t j = 1; j < bn; ++j)
+            r[an + j] = addmul_1(r + j, a, an, b[j]);
+    }
+
+    void sqr_basecase(uint32_t *r, const uint32_t *a, size_t n) {
+        //every a[i] * a[j] with i < j once, doubled, then the squares on the diagonal
+        std::fill(r, r + 2 * n, 0);
+        for (size_t i = 0; i + 1 < n; ++i)
+            r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        lshift(r, r, 2 * n, 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t sq = (uint64_t)a[i] * a[i];
+            carry += (uint64_t)r[2 * i] + (uint32_t)sq;
+            r[2 * i] = (uint32_t)carry;
+            carry >>= 32;
+            carry += (uint64_t)r[2 * i + 1] + (sq >> 32);
+            r[2 * i + 1] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+
+    void mont_mul(uint32_t *r, const uint32_t *a, const uint32_t *b, const uint32_t *m, size_t n, uint32_t minv,
+                  uint32_t *t) {
+        std::fill(t, t + n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            //t = (t + a * b[i] + q * m) / 2^32 with q chosen so that the division is exact; t stays below 2m
+            const uint32_t bi = b[i];
+            uint64_t p = (uint64_t)a[0] * bi + t[0];
+            const uint32_t q = (uint32_t)p * minv;
+            uint64_t s = (uint64_t)q * m[0] + (uint32_t)p;
+            uint64_t pc = p >> 32, sc = s >> 32;
+            for (size_t j = 1; j < n; ++j) {
+                p = (uint64_t)a[j] * bi + t[j] + pc;
+                pc = p >> 32;
+                s = (uint64_t)q * m[j] + (uint32_t)p + sc;
+                sc = s >> 32;
+                t[j - 1] = (uint32_t)s;
+            }
+            uint64_t top = (uint64_t)t[n] + pc + sc;
+            t[n - 1] = (uint32_t)top;
+            t[n] = (uint32_t)(top >> 32);
+        }
+        if (t[n] || cmp(t, m, n) >= 0)
+            sub_n(r, t, m, n);
+        else
+            std::copy(t, t + n, r);
+    }
+
+    void mont_redc(uint32_t *r, uint32_t *t, const uint32_t *m, size_t n, uint32_t minv) {
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t carry = addmul_1(t + i, m, n, t[i] * minv);
+            add_1(t + i + n, t + i + n, n + 1 - i, carry);
+        }
+        if (t[2 * n] || cmp(t + n, m, n) >= 0)
+            sub_n(r, t + n, m, n);
+        else
+            std::copy(t + n, t + 2 * n, r);
+    }
+
+    void divrem_normalized(uint32_t *q, uint32_t *u, size_t un, const uint32_t *v, size_t vn) {
+        const uint32_t vtop = v[vn - 1], vnext = v[vn - 2];
+        for (size_t j = un - vn; j--; ) {
+            //estimate the quotient limb from the top two limbs, it's at most two too big
+            uint64_t num = ((uint64_t)u[j + vn] << 32) | u[j + vn - 1];
+            uint64_t qhat = num / vtop;
+            uint64_t rhat = num % vtop;
+            while (qhat >> 32 || qhat * vnext > ((rhat << 32) | u[j + vn - 2])) {
+                --qhat;
+                rhat += vtop;
+                if (rhat >> 32)
+                    break;
+            }
+            uint32_t borrow = submul_1(u + j, v, vn, (uint32_t)qhat);
+            bool negative = u[j + vn] < borrow;
+            u[j + vn] -= borrow;
+            if (negative) { //rare: qhat was still one too big
+                --qhat;
+                u[j + vn] += add_n(u + j, u + j, v, vn);
+            }
+            q[j] = (uint32_t)qhat;
+        }
+    }
+
+    void divrem(uint32_t *q, uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn) {
+        if (bn == 1) {
+            r[0] = divrem_1(q, a, an, b[0]);
+            return;
+        }
+        int shift = 31 - maxbit(b[bn - 1]);
+        std::vector<uint32_t> u(an + 1), v(b, b + bn);
+        if (shift) {
+            lshift(v.data(), b, bn, shift);
+            u[an] = lshift(u.data(), a, an, shift);
+        }
+        else
+            std::copy(a, a + an, u.begin());
+        divrem_normalized(q, u.data(), an + 1, v.data(), bn);
+        if (shift)
+            rshift(r, u.data(), bn, shift);
+        else
+            std::copy(u.begin(), u.begin() + bn, r);
+    }
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//Low level loops over raw limb arrays, least significant limb first. Unless said otherwise the arrays are unsigned
+//magnitudes, not two's complement. Nothing here allocates, the caller owns every buffer.
+//Used by big_integer.cpp and the algorithm files built on top of it, not meant to be included by users.
+
+namespace big_integer_detail
+{
+    const uint32_t BASE = UINT32_MAX; //not really base but actually BASE - 1
+
+    inline uint32_t filler(uint32_t x) { //the thing that we are using if we're filling the number in two complement form
+        return (x >> 31 ? BASE : 0);
+    }
+
+    inline int maxbit(uint32_t n) { //Pre: n != 0
+#ifdef __GNUC__
+        return 31 - __builtin_clz(n);
+#else
+        int temp = -1;
+        while (n) {
+            n >>= 1;
+            ++temp;
+        }
+        return temp;
+#endif
+    }
+
+    //The scans from the top, 8 or 16 limbs per compare on AVX2 or AVX-512 with the position taken from the mask.
+    //strip_fill is the length of a without its leading limbs equal to fill, diff_length is one past the highest limb
+    //where a and b differ, 0 if they are equal
+    size_t strip_fill(const uint32_t *a, size_t n, uint32_t fill);
+    size_t diff_length(const uint32_t *a, const uint32_t *b, size_t n);
+
+    inline size_t strip(const uint32_t *a, size_t n) { //length without the leading zero limbs
+        return strip_fill(a, n, 0);
+    }
+
+    inline int trailing_zeros(uint64_t x) { //Pre: x != 0
+#ifdef __GNUC__
+        return __builtin_ctzll(x);
+#else
+        int r = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            ++r;
+        }
+        return r;
+#endif
+    }
+
+    //zero bits below the lowest set one of a. Pre: a isn't all zeros
+    inline size_t trailing_zeros(const uint32_t *a) {
+        size_t i = 0;
+        while (a[i] == 0)
+            ++i;
+        return 32 * i + trailing_zeros(a[i]);
+    }
+
+    //bits in the magnitude a[0, n), 0 for zero
+    inline size_t bit_length(const uint32_t *a, size_t n) {
+        n = strip(a, n);
+        return n == 0 ? 0 : (n - 1) * 32 + maxbit(a[n - 1]) + 1;
+    }
+
+    //the low 64 bits of a[0, n)
+    inline uint64_t to_64(const uint32_t *a, size_t n) {
+        return (n > 0 ? a[0] : 0) | (uint64_t)(n > 1 ? a[1] : 0) << 32;
+    }
+
+    inline int cmp(const uint32_t *a, const uint32_t *b, size_t n) {
+        const size_t i = diff_length(a, b, n);
+        if (i == 0)
+            return 0;
+        return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+
+    inline int cmp(const uint32_t *a, size_t an, const uint32_t *b, size_t bn) {
+        an = strip(a, an);
+        bn = strip(b, bn);
+        if (an != bn)
+            return an < bn ? -1 : 1;
+        return cmp(a, b, an);
+    }
+
+    //r = a + b, returns the carry; r may be a or b
+    inline uint32_t add_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t sum = (uint64_t)a[i] + b[i] + carry;
+            r[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        return carry;
+    }
+
+    inline uint32_t add_1(uint32_t *r, const uint32_t *a, size_t n, uint32_t b) {
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t sum = (uint64_t)a[i] + b;
+            r[i] = (uint32_t)sum;
+            b = sum >> 32;
+        }
+        return b;
+    }
+
+    //r = a + b for an >= bn, returns the carry
+    inline uint32_t add(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn) {
+        uint32_t carry = add_n(r, a, b, bn);
+        return add_1(r + bn, a + bn, an - bn, carry);
+    }
+
+    //r = a - b, returns the borrow; r may be a or b
+    inline uint32_t sub_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n) {
+        uint32_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t diff = (uint64_t)a[i] - b[i] - borrow;
+            r[i] = (uint32_t)diff;
+            borrow = diff >> 63;
+        }
+        return borrow;
+    }
+
+    inline uint32_t sub_1(uint32_t *r, const uint32_t *a, size_t n, uint32_t b) {
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t diff = (uint64_t)a[i] - b;
+            r[i] = (uint32_t)diff;
+            b = diff >> 63;
+        }
+        return b;
+    }
+
+    //r = a - b for an >= bn, returns the borrow
+    inline uint32_t sub(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn) {
+        uint32_t borrow = sub_n(r, a, b, bn);
+        return sub_1(r + bn, a + bn, an - bn, borrow);
+    }
+
+    //r = a * b, returns the limb that didn't fit
+    inline uint32_t mul_1(uint32_t *r, const uint32_t *a, size_t n, uint32_t b) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t res = (uint64_t)a[i] * b + carry;
+            r[i] = (uint32_t)res;
+            carry = res >> 32;
+        }
+        return carry;
+    }
+
+    //r += a * b, returns the limb that didn't fit
+    inline uint32_t addmul_1(uint32_t *r, const uint32_t *a, size_t n, uint32_t b) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t res = (uint64_t)a[i] * b + carry + r[i];
+            r[i] = (uint32_t)res;
+            carry = res >> 32;
+        }
+        return carry;
+    }
+
+    //r -= a * b, returns the limb that has to be borrowed from above
+    inline uint32_t submul_1(uint32_t *r, const uint32_t *a, size_t n, uint32_t b) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t res = (uint64_t)a[i] * b + carry;
+            uint32_t lo = (uint32_t)res;
+            carry = (uint32_t)(res >> 32) + (r[i] < lo);
+            r[i] -= lo;
+        }
+        return carry;
+    }
+
+    //q = a / d, returns a % d; q may be a
+    inline uint32_t divrem_1(uint32_t *q, const uint32_t *a, size_t n, uint32_t d) {
+        uint32_t carry = 0;
+        for (size_t i = n; i--; ) {
+            uint64_t cur = ((uint64_t)carry << 32) | a[i];
+            q[i] = (uint32_t)(cur / d);
+            carry = (uint32_t)(cur % d);
+        }
+        return carry;
+    }
+
+    //a % d without the quotient
+    inline uint32_t mod_1(const uint32_t *a, size_t n, uint32_t d) {
+        uint64_t carry = 0;
+        for (size_t i = n; i--; )
+            carry = ((carry << 32) | a[i]) % d;
+        return (uint32_t)carry;
+    }
+
+    //r = a << k for 0 < k < 32 in a single pass, returns the bits shifted out; r may be a or anywhere above it,
+    //so a shift by whole limbs as well can be done in place
+    uint32_t lshift(uint32_t *r, const uint32_t *a, size_t n, int k);
+
+    //r = a >> k for 0 < k < 32 in a single pass, returns the bits shifted out (in the high end of the limb); r may be
+    //a or anywhere below it
+    uint32_t rshift(uint32_t *r, const uint32_t *a, size_t n, int k);
+
+    //r = -a in two's complement, i.e. ~a + 1; r may be a
+    inline void negate(uint32_t *r, const uint32_t *a, size_t n) {
+        uint32_t carry = 1;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t cur = (uint64_t)(uint32_t)~a[i] + carry;
+            r[i] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+    }
+
+    //r = a & b, a | b, a ^ b, a & ~b and ~a limb by limb; r may be a or b. These run on AVX2 or AVX-512 when the
+    //processor has it, checked once at startup. The sign extension of a shorter operand is all zeros or all ones,
+    //so callers handle that tail with a fill, nothing at all or not_n
+    void and_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+    void or_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+    void xor_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+    void andnot_n(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t n);
+    void not_n(uint32_t *r, const uint32_t *a, size_t n);
+
+    //r[0, an + bn) = a * b, r must not overlap a or b
+    void mul_basecase(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn);
+
+    //r[0, 2n) = a * a, about half the multiplications of mul_basecase; r must not overlap a
+    void sqr_basecase(uint32_t *r, const uint32_t *a, size_t n);
+
+    //-m^-1 mod 2^32 for an odd m
+    inline uint32_t mont_inverse(uint32_t m) {
+        uint32_t x = m; //right in the low 3 bits, every Newton step doubles that
+        for (int i = 0; i < 4; ++i)
+            x *= 2 - m * x;
+        return -x;
+    }
+
+    //Montgomery multiplication, r = a * b / 2^(32n) mod m for an odd m[0, n), minv = mont_inverse(m[0]) and a, b < m.
+    //Multiplication and reduction are fused into a single pass per limb of b. t is scratch of n + 1 limbs, r may be a or b
+    void mont_mul(uint32_t *r, const uint32_t *a, const uint32_t *b, const uint32_t *m, size_t n, uint32_t minv,
+                  uint32_t *t);
+
+    //Montgomery reduction, r = t / 2^(32n) mod m for t[0, 2n + 1) < m * 2^(32n); t is destroyed
+    void mont_redc(uint32_t *r, uint32_t *t, const uint32_t *m, size_t n, uint32_t minv);
+
+    //Knuth's algorithm D. Pre: vn >= 2, the top bit of v[vn - 1] is set, un > vn and u[un - 1] < v[vn - 1].
+    //q[0, un - vn) gets the quotient, the remainder is left in u[0, vn)
+    void divrem_normalized(uint32_t *q, uint32_t *u, size_t un, const uint32_t *v, size_t vn);
+
+    //q[0, an - bn + 1) = a / b, r[0, bn) = a % b for an >= bn, b[bn - 1] != 0. The only function here that
+    //allocates: a normalized copy of a and b
+    void divrem(uint32_t *q, uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn);
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "big_integer.h"
+#include "fixed_big_integer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//compile-time big integer constants:
+//    using namespace big_integer_literals;
+//    big_integer p = 0xffffffff00000001000000000000000000000000ffffffffffffffffffffffff_bi;
+//    constexpr fixed_big_integer<128> q = -170141183460469231731687303715884105728_bi;
+//decimal, 0x hex, 0b binary and 0 octal digits (with ' separators) are parsed by the compiler,
+//at run time a big_integer only copies the finished limbs. Any other character, or a digit too big for the base,
+//is a compile error
+
+namespace big_integer_detail
+{
+    //0x hex, 0b binary, a leading 0 octal, decimal otherwise; start is where the digits begin
+    constexpr uint32_t literal_base(const char *s, size_t n, size_t &start) {
+        start = 0;
+        if (n > 1 && s[0] == '0') {
+            if (s[1] == 'x' || s[1] == 'X') {
+                start = 2;
+                return 16;
+            }
+            if (s[1] == 'b' || s[1] == 'B') {
+                start = 2;
+                return 2;
+            }
+            start = 1;
+            return 8;
+        }
+        return 10;
+    }
+
+    //the value of the digit c, 36 for anything that isn't one in any base
+    constexpr uint32_t literal_digit(char c) {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+            return (c | 0x20) - 'a' + 10;
+        return 36;
+    }
+
+    //only digits of the literal's base, with a ' only right between two digits. The literal operator gets floating
+    //literals too, so 1.5_bi, 1e3_bi and 0x1p4_bi end up here as well as 08_bi
+    constexpr bool valid_literal(const char *s, size_t n) {
+        size_t start = 0;
+        const uint32_t base = literal_base(s, n, start);
+        if (start == n && base != 8) //a bare 0x or 0b
+            return false;
+        for (size_t i = start; i < n; ++i) {
+            if (s[i] == '\'') {
+                if (i == 0 || literal_digit(s[i - 1]) >= base || i + 1 == n || literal_digit(s[i + 1]) >= base)
+                    return false;
+            }
+            else if (literal_digit(s[i]) >= base)
+                return false;
+        }
+        return true;
+    }
+}
+
+template <size_t L>
+class big_integer_literal
+{
+public:
+    constexpr big_integer_literal(const char *s, size_t n);
+
+    constexpr big_integer_literal operator+() const;
+    constexpr big_integer_literal operator-() const;
+
+    operator big_integer() const;
+    template <size_t N>
+    constexpr operator fixed_big_integer<N>() const; //keeps the lowest N bits, like fixed_big_integer(big_integer)
+
+private:
+    uint32_t data[L];
+    size_t size;
+    static constexpr uint32_t filler(uint32_t x);
+    constexpr void normalize();
+};
+
+template <size_t L>
+constexpr uint32_t big_integer_literal<L>::filler(uint32_t x) {
+    return x >> 31 ? UINT32_MAX : 0;
+}
+
+template <size_t L>
+constexpr big_integer_literal<L>::big_integer_literal(const char *s, size_t n) :
+    data{},
+    size(L)
+{
+    size_t i = 0;
+    const uint32_t base = big_integer_detail::literal_base(s, n, i);
+    for (; i < n; ++i) {
+        if (s[i] == '\'')
+            continue;
+        uint32_t carry = big_integer_detail::literal_digit(s[i]);
+        for (size_t j = 0; j < L; ++j) {
+            uint64_t cur = (uint64_t)data[j] * base + carry;
+            data[j] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+    }
+    normalize();
+}
+
+template <size_t L>
+constexpr void big_integer_literal<L>::normalize() {
+    size = L;
+    while (size > 1 && data[size - 1] == filler(data[size - 2]))
+        --size;
+}
+
+template <size_t L>
+constexpr big_integer_literal<L> big_integer_literal<L>::operator + () const {
+    return *this;
+}
+
+template <size_t L>
+constexpr big_integer_literal<L> big_integer_literal<L>::operator - () const {
+    //L always has a spare limb for the sign, so the negation can't overflow
+    big_integer_literal r = *this;
+    uint32_t carry = 1;
+    for (size_t i = 0; i < L; ++i) {
+        uint64_t cur = (uint64_t)(uint32_t)~data[i] + carry;
+        r.data[i] = (uint32_t)cur;
+        carry = cur >> 32;
+    }
+    r.normalize();
+    return r;
+}
+
+template <size_t L>
+big_integer_literal<L>::operator big_integer() const {
+    return big_integer(data, size);
+}
+
+template <size_t L>
+template <size_t N>
+constexpr big_integer_literal<L>::operator fixed_big_integer<N>() const {
+    fixed_big_integer<N> r;
+    for (size_t i = 0; i < fixed_big_integer<N>::LIMBS; ++i)
+        r.set_limb(i, i < size ? data[i] : filler(data[size - 1]));
+    return r;
+}
+
+namespace big_integer_detail
+{
+    //every digit takes at most 4 bits, plus one limb for the sign
+    template <char... Cs>
+    struct literal_limbs
+    {
+        static constexpr size_t value = sizeof...(Cs) / 8 + 2;
+    };
+
+    template <char... Cs>
+    constexpr bool valid_literal() {
+        const char s[] = { Cs... };
+        return valid_literal(s, sizeof...(Cs));
+    }
+
+    template <char... Cs>
+    constexpr big_integer_literal<literal_limbs<Cs...>::value> parse_literal() {
+        static_assert(valid_literal<Cs...>(), "a _bi literal may only have digits of its base and ' between two digits");
+        const char s[] = { Cs... };
+        return big_integer_literal<literal_limbs<Cs...>::value>(s, sizeof...(Cs));
+    }
+
+    //a static constexpr member is a constant expression, so the parsing never happens at run time, not even at -O0
+    template <char... Cs>
+    struct literal_value
+    {
+        static constexpr big_integer_literal<literal_limbs<Cs...>::value> value = parse_literal<Cs...>();
+    };
+
+    template <char... Cs>
+    constexpr big_integer_literal<literal_limbs<Cs...>::value> literal_value<Cs...>::value;
+}
+
+namespace big_integer_literals
+{
+    template <char... Cs>
+    constexpr big_integer_literal<big_integer_detail::literal_limbs<Cs...>::value> operator"" _bi() {
+        return big_integer_detail::literal_value<Cs...>::value;
+    }
+}
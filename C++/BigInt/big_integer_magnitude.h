@@ -0,0 +1,51 @@
+#pragma once
+
+#include "big_integer.h"
+#include "big_integer_kernels.h"
+#include <vector>
+
+//Going between big_integer and the unsigned magnitudes the kernels work on, for big_integer.cpp and the files built
+//on top of it. Not meant to be included by users.
+
+namespace big_integer_detail
+{
+    //|a| without the leading zero limbs, empty for zero
+    inline void magnitude(big_integer_view a, std::vector<uint32_t> &out) {
+        out.assign(a.data(), a.data() + a.size());
+        if (a.negative())
+            negate(out.data(), out.data(), out.size());
+        out.resize(strip(out.data(), out.size()));
+    }
+
+    //|a| without the leading zero limbs in n, points into a itself unless a is negative
+    inline const uint32_t *magnitude(big_integer_view a, std::vector<uint32_t> &scratch, size_t &n) {
+        const uint32_t *p = a.data();
+        if (a.negative()) {
+            scratch.resize(a.size());
+            negate(scratch.data(), p, a.size());
+            p = scratch.data();
+        }
+        n = strip(p, a.size());
+        return p;
+    }
+
+    //the number with magnitude a[0, n), negative if neg
+    inline big_integer from_magnitude(const uint32_t *a, size_t n, bool neg = false) {
+        big_integer r;
+        assign_magnitude(r, a, n, neg);
+        return r;
+    }
+
+    inline big_integer from_64(uint64_t x) {
+        const uint32_t limbs[2] = { (uint32_t)x, (uint32_t)(x >> 32) };
+        return from_magnitude(limbs, 2);
+    }
+
+    inline size_t bit_length(big_integer_view a) { //Pre: a >= 0
+        return bit_length(a.data(), a.size());
+    }
+
+    inline uint64_t to_64(big_integer_view a) { //Pre: 0 <= a < 2^64
+        return to_64(a.data(), a.size());
+    }
+}
@@ -0,0 +1,457 @@
+#include "big_integer_modular.h"
+#include "big_integer_gcd.h"
+#include "big_integer_magnitude.h"
+#include <algorithm>
+#include <vector>
+
+using namespace big_integer_detail;
+
+//The exponentiation is written once against a "reduction": something that keeps residues modulo m in some
+//internal form of size() limbs and can multiply and square them there. enter/leave convert to and from
+//plain residues; r may be the same as any of the arguments.
+
+namespace
+{
+    //a one-limb modulus, everything fits into machine words
+    class word_reduction
+    {
+    public:
+        explicit word_reduction(uint32_t m) :
+            m(m) {
+        }
+
+        size_t size() const {
+            return 1;
+        }
+
+        void enter(uint32_t *r, const uint32_t *x) const {
+            r[0] = x[0];
+        }
+
+        void leave(uint32_t *r, const uint32_t *x) const {
+            r[0] = x[0];
+        }
+
+        void mul(uint32_t *r, const uint32_t *a, const uint32_t *b) const {
+            r[0] = (uint32_t)((uint64_t)a[0] * b[0] % m);
+        }
+
+        void sqr(uint32_t *r, const uint32_t *a) const {
+            mul(r, a, a);
+        }
+
+    private:
+        uint32_t m;
+    };
+
+    //moduli of two limbs or more that aren't odd
+    class barrett_reduction
+    {
+    public:
+        explicit barrett_reduction(const barrett_reducer &red) :
+            red(red),
+            scratch(red.scratch_size()) {
+        }
+
+        size_t size() const {
+            return red.size();
+        }
+
+        void enter(uint32_t *r, const uint32_t *x) const {
+            std::copy(x, x + size(), r);
+        }
+
+        void leave(uint32_t *r, const uint32_t *x) const {
+            std::copy(x, x + size(), r);
+        }
+
+        void mul(uint32_t *r, const uint32_t *a, const uint32_t *b) {
+            red.mul(r, a, b, scratch.data());
+        }
+
+        void sqr(uint32_t *r, const uint32_t *a) {
+            red.sqr(r, a, scratch.data());
+        }
+
+    private:
+        const barrett_reducer &red;
+        std::vector<uint32_t> scratch;
+    };
+
+    //odd moduli. With convert the residues are moved into Montgomery form and back, without it they already are
+    class montgomery_reduction
+    {
+    public:
+        montgomery_reduction(const montgomery_context &ctx, bool convert) :
+            ctx(ctx),
+            convert(convert),
+            scratch(ctx.scratch_size()) {
+        }
+
+        size_t size() const {
+            return ctx.size();
+        }
+
+        void enter(uint32_t *r, const uint32_t *x) {
+            if (convert)
+                ctx.to_montgomery(r, x, scratch.data());
+            else
+                std::copy(x, x + size(), r);
+        }
+
+        void leave(uint32_t *r, const uint32_t *x) {
+            if (convert)
+                ctx.from_montgomery(r, x, scratch.data());
+            else
+                std::copy(x, x + size(), r);
+        }
+
+        void mul(uint32_t *r, const uint32_t *a, const uint32_t *b) {
+            ctx.mul(r, a, b, scratch.data());
+        }
+
+        void sqr(uint32_t *r, const uint32_t *a) {
+            ctx.sqr(r, a, scratch.data());
+        }
+
+    private:
+        const montgomery_context &ctx;
+        bool convert;
+        std::vector<uint32_t> scratch;
+    };
+
+    //a^-1 mod m for a coprime to m
+    uint32_t invmod_word(uint32_t a, uint32_t m) {
+        int64_t r0 = m, r1 = a % m, s0 = 0, s1 = 1;
+        while (r1 != 0) {
+            int64_t q = r0 / r1, t = r0 - q * r1;
+            r0 = r1;
+            r1 = t;
+            t = s0 - q * s1;
+            s0 = s1;
+            s1 = t;
+        }
+        return (uint32_t)(s0 < 0 ? s0 + m : s0);
+    }
+
+    uint32_t mulmod_word(uint32_t a, uint32_t b, uint32_t m) {
+        return (uint32_t)((uint64_t)a * b % m);
+    }
+
+    const size_t GARNER_LIMIT = 16; //moduli; above that the quadratic number of word operations starts to tell
+
+    //x = v[0] + v[1] m[0] + v[2] m[0] m[1] + ..., every v[j] is found with word arithmetic modulo m[j]
+    big_integer crt_garner(const std::vector<uint32_t> &r, const std::vector<uint32_t> &m) {
+        const size_t k = m.size();
+        std::vector<uint32_t> v(k);
+        for (size_t j = 0; j < k; ++j) {
+            uint32_t x = 0, p = 1 % m[j]; //the part found so far and m[0] ... m[j - 1], both modulo m[j]
+            for (size_t i = 0; i < j; ++i) {
+                x = (uint32_t)((x + (uint64_t)v[i] * p) % m[j]);
+                p = mulmod_word(p, m[i] % m[j], m[j]);
+            }
+            v[j] = mulmod_word((r[j] % m[j] + m[j] - x) % m[j], invmod_word(p, m[j]), m[j]);
+        }
+        big_integer x = 0;
+        for (size_t j = k; j-- > 0; ) {
+            x *= big_integer(m[j]);
+            x += big_integer(v[j]);
+        }
+        return x;
+    }
+
+    big_integer crt_tree(const std::vector<uint32_t> &r, const std::vector<uint32_t> &m) {
+        //tree[l][j] is the product of the moduli under node j of level l, its children are 2j and 2j + 1 below
+        std::vector<std::vector<big_integer>> tree(1);
+        for (uint32_t x : m)
+            tree[0].push_back(big_integer(x));
+        while (tree.back().size() > 1) {
+            const std::vector<big_integer> &below = tree.back();
+            std::vector<big_integer> level;
+            for (size_t j = 0; j < below.size(); j += 2)
+                level.push_back(j + 1 < below.size() ? below[j] * below[j + 1] : below[j]);
+            tree.push_back(std::move(level));
+        }
+        //going down, M mod (node product)^2; at a leaf that's enough to get (M / m[i]) mod m[i]
+        std::vector<big_integer> rem(1, tree.back()[0]);
+        for (size_t l = tree.size() - 1; l-- > 0; ) {
+            std::vector<big_integer> next;
+            for (size_t j = 0; j < tree[l].size(); ++j)
+                next.push_back(rem[j / 2] % (tree[l][j] * tree[l][j]));
+            rem.swap(next);
+        }
+        //going up, the weighted residues multiplied by the products of the other moduli and summed pairwise
+        std::vector<big_integer> sum;
+        for (size_t i = 0; i < m.size(); ++i) {
+            uint64_t t = to_64(rem[i]);
+            uint32_t c = (uint32_t)(t / m[i] % m[i]);
+            sum.push_back(big_integer(mulmod_word(r[i] % m[i], invmod_word(c, m[i]), m[i])));
+        }
+        for (size_t l = 0; l + 1 < tree.size(); ++l) {
+            std::vector<big_integer> next;
+            for (size_t j = 0; j < sum.size(); j += 2)
+                next.push_back(j + 1 < sum.size() ? sum[j] * tree[l][j + 1] + sum[j + 1] * tree[l][j] : sum[j]);
+            sum.swap(next);
+        }
+        return sum[0] % tree.back()[0];
+    }
+
+    bool test_bit(const uint32_t *e, size_t i) {
+        return e[i / 32] >> (i % 32) & 1;
+    }
+
+    //window width that minimizes the multiplications for an exponent of that many bits, table building included
+    int window_bits(size_t bits) {
+        static const size_t LIMITS[] = { 7, 25, 81, 241, 673 };
+        int k = 1;
+        while (k <= 5 && bits > LIMITS[k - 1])
+            ++k;
+        return k;
+    }
+
+    //r = b^e in the reduction's internal form converted back, b is a residue of red.size() limbs. Pre: e[en - 1] != 0
+    template <class Reduction>
+    void powmod_window(Reduction &red, uint32_t *r, const uint32_t *b, const uint32_t *e, size_t en) {
+        const size_t n = red.size();
+        const size_t bits = bit_length(e, en);
+        const int k = window_bits(bits);
+        //table[i] = b^(2i + 1), the only values a window can start with
+        std::vector<uint32_t> table(n << (k - 1)), b2(n);
+        red.enter(table.data(), b);
+        red.sqr(b2.data(), table.data());
+        for (size_t i = 1; i < (size_t)1 << (k - 1); ++i)
+            red.mul(&table[i * n], &table[(i - 1) * n], b2.data());
+        bool started = false;
+        for (size_t i = bits; i > 0; ) { //bits [i, bits) are done
+            if (!test_bit(e, i - 1)) {
+                red.sqr(r, r);
+                --i;
+                continue;
+            }
+            //the longest window [j, i) of at most k bits that ends with a one
+            size_t j = i > (size_t)k ? i - k : 0;
+            while (!test_bit(e, j))
+                ++j;
+            uint32_t w = 0;
+            for (size_t t = i; t-- > j; )
+                w = w << 1 | test_bit(e, t);
+            const uint32_t *odd = &table[(w >> 1) * n];
+            if (started) {
+                for (size_t t = j; t < i; ++t)
+                    red.sqr(r, r);
+                red.mul(r, r, odd);
+            }
+            else {
+                std::copy(odd, odd + n, r);
+                started = true;
+            }
+            i = j;
+        }
+        red.leave(r, r);
+    }
+}
+
+big_integer powmod(big_integer_view base, big_integer_view exp, big_integer_view m) {
+    std::vector<uint32_t> mm, e, b;
+    magnitude(m, mm);
+    magnitude(exp, e);
+    const size_t n = mm.size();
+    if (n == 0 || (n == 1 && mm[0] == 1))
+        return 0;
+    if (e.empty())
+        return 1;
+    big_integer reduced = big_integer(base) % m;
+    if (reduced < 0)
+        reduced += m;
+    magnitude(reduced, b);
+    b.resize(n);
+    std::vector<uint32_t> r(n);
+    if (n == 1) {
+        word_reduction red(mm[0]);
+        powmod_window(red, r.data(), b.data(), e.data(), e.size());
+    }
+    else if (mm[0] & 1) {
+        montgomery_context ctx(m);
+        montgomery_reduction red(ctx, true);
+        powmod_window(red, r.data(), b.data(), e.data(), e.size());
+    }
+    else {
+        barrett_reducer reducer(m);
+        barrett_reduction red(reducer);
+        powmod_window(red, r.data(), b.data(), e.data(), e.size());
+    }
+    return from_magnitude(r.data(), n);
+}
+
+big_integer invmod(big_integer_view a, big_integer_view m) {
+    big_integer x, y, r = big_integer(a) % m;
+    if (gcdext(r, m, x, y) != 1)
+        return 0;
+    x %= m;
+    if (x < 0)
+        x += m;
+    return x;
+}
+
+big_integer crt_combine(const std::vector<uint32_t> &residues, const std::vector<uint32_t> &moduli) {
+    if (moduli.empty())
+        return 0;
+    return moduli.size() <= GARNER_LIMIT ? crt_garner(residues, moduli) : crt_tree(residues, moduli);
+}
+
+montgomery_context::montgomery_context(big_integer_view m) :
+    m(m)
+{
+    magnitude(m, limbs);
+    const size_t n = limbs.size();
+    minv = mont_inverse(limbs[0]);
+    magnitude((big_integer(1) << (int)(64 * n)) % this->m, r2);
+    r2.resize(n);
+}
+
+void montgomery_context::to_montgomery(uint32_t *r, const uint32_t *a, uint32_t *scratch) const {
+    mont_mul(r, a, r2.data(), limbs.data(), limbs.size(), minv, scratch);
+}
+
+void montgomery_context::from_montgomery(uint32_t *r, const uint32_t *a, uint32_t *scratch) const {
+    //a * 1 / R, as a REDC of a itself
+    const size_t n = limbs.size();
+    std::copy(a, a + n, scratch);
+    std::fill(scratch + n, scratch + 2 * n + 1, 0);
+    mont_redc(r, scratch, limbs.data(), n, minv);
+}
+
+void montgomery_context::mul(uint32_t *r, const uint32_t *a, const uint32_t *b, uint32_t *scratch) const {
+    mont_mul(r, a, b, limbs.data(), limbs.size(), minv, scratch);
+}
+
+void montgomery_context::sqr(uint32_t *r, const uint32_t *a, uint32_t *scratch) const {
+    const size_t n = limbs.size();
+    sqr_basecase(scratch, a, n);
+    scratch[2 * n] = 0;
+    mont_redc(r, scratch, limbs.data(), n, minv);
+}
+
+void montgomery_context::load(uint32_t *r, big_integer_view a) const {
+    //a is a residue, so apart from a possible zero sign limb it fits
+    const size_t n = std::min(a.size(), limbs.size());
+    std::copy(a.data(), a.data() + n, r);
+    std::fill(r + n, r + limbs.size(), 0);
+}
+
+big_integer montgomery_context::store(const uint32_t *a) const {
+    return from_magnitude(a, limbs.size());
+}
+
+big_integer montgomery_context::to_montgomery(big_integer_view a) const {
+    big_integer x = big_integer(a) % m;
+    if (x < 0)
+        x += m;
+    std::vector<uint32_t> r(size()), scratch(scratch_size());
+    load(r.data(), x);
+    to_montgomery(r.data(), r.data(), scratch.data());
+    return store(r.data());
+}
+
+big_integer montgomery_context::from_montgomery(big_integer_view a) const {
+    std::vector<uint32_t> r(size()), scratch(scratch_size());
+    load(r.data(), a);
+    from_montgomery(r.data(), r.data(), scratch.data());
+    return store(r.data());
+}
+
+big_integer montgomery_context::mul(big_integer_view a, big_integer_view b) const {
+    std::vector<uint32_t> x(size()), y(size()), scratch(scratch_size());
+    load(x.data(), a);
+    load(y.data(), b);
+    mul(x.data(), x.data(), y.data(), scratch.data());
+    return store(x.data());
+}
+
+big_integer montgomery_context::sqr(big_integer_view a) const {
+    std::vector<uint32_t> x(size()), scratch(scratch_size());
+    load(x.data(), a);
+    sqr(x.data(), x.data(), scratch.data());
+    return store(x.data());
+}
+
+big_integer montgomery_context::pow(big_integer_view a, big_integer_view e) const {
+    std::vector<uint32_t> em;
+    magnitude(e, em);
+    if (em.empty())
+        return to_montgomery(big_integer(1));
+    std::vector<uint32_t> x(size()), r(size());
+    load(x.data(), a);
+    montgomery_reduction red(*this, false);
+    powmod_window(red, r.data(), x.data(), em.data(), em.size());
+    return store(r.data());
+}
+
+barrett_reducer::barrett_reducer(big_integer_view m) :
+    m(m)
+{
+    magnitude(m, limbs);
+    magnitude((big_integer(1) << (int)(64 * limbs.size())) / this->m, mu);
+    mu.resize(limbs.size() + 1);
+}
+
+void barrett_reducer::reduce_2n(uint32_t *r, const uint32_t *x, uint32_t *scratch) const {
+    //q = floor(floor(x / B^(n - 1)) * mu / B^(n + 1)) is at most two below floor(x / m), so x - q * m is
+    //below 3m and only its low n + 1 limbs matter. Uses the first 5n + 4 limbs of scratch, r may be in x
+    const size_t n = limbs.size();
+    uint32_t *q = scratch, *qm = q + 2 * n + 2, *t = qm + 2 * n + 1;
+    mul_basecase(q, x + n - 1, n + 1, mu.data(), n + 1);
+    mul_basecase(qm, q + n + 1, n + 1, limbs.data(), n);
+    sub_n(t, x, qm, n + 1);
+    while (t[n] || cmp(t, limbs.data(), n) >= 0)
+        t[n] -= sub_n(t, t, limbs.data(), n);
+    std::copy(t, t + n, r);
+}
+
+void barrett_reducer::reduce(uint32_t *r, const uint32_t *x, size_t xn, uint32_t *scratch) const {
+    const size_t n = limbs.size();
+    uint32_t *w = scratch + 5 * n + 4; //2n limbs that reduce_2n leaves alone
+    if (xn <= 2 * n) {
+        std::copy(x, x + xn, w);
+        std::fill(w + xn, w + 2 * n, 0);
+        reduce_2n(r, w, scratch);
+        return;
+    }
+    //Horner's scheme from the top: the remainder so far sits in the high half of w, shifted up by the next group
+    //of limbs it's still below B^(2n). Only the first group can be shorter than n
+    std::fill(w + n, w + 2 * n, 0);
+    for (size_t pos = xn; pos > 0; ) {
+        const size_t step = pos % n ? pos % n : n;
+        pos -= step;
+        if (step != n) {
+            std::copy(w + n, w + 2 * n, w + step);
+            std::fill(w + step + n, w + 2 * n, 0);
+        }
+        std::copy(x + pos, x + pos + step, w);
+        reduce_2n(w + n, w, scratch);
+    }
+    std::copy(w + n, w + 2 * n, r);
+}
+
+void barrett_reducer::mul(uint32_t *r, const uint32_t *a, const uint32_t *b, uint32_t *scratch) const {
+    const size_t n = limbs.size();
+    uint32_t *w = scratch + 5 * n + 4;
+    mul_basecase(w, a, n, b, n);
+    reduce_2n(r, w, scratch);
+}
+
+void barrett_reducer::sqr(uint32_t *r, const uint32_t *a, uint32_t *scratch) const {
+    const size_t n = limbs.size();
+    uint32_t *w = scratch + 5 * n + 4;
+    sqr_basecase(w, a, n);
+    reduce_2n(r, w, scratch);
+}
+
+big_integer barrett_reducer::reduce(big_integer_view a) const {
+    std::vector<uint32_t> x, r(size()), scratch(scratch_size());
+    magnitude(a, x);
+    if (x.empty())
+        return 0;
+    reduce(r.data(), x.data(), x.size(), scratch.data());
+    return from_magnitude(r.data(), r.size(), a.negative());
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "big_integer.h"
+#include <vector>
+
+//base^exp mod m, the result is in [0, m) even for a negative base. Pre: exp >= 0, m > 0.
+//Scans the exponent with a sliding window over precomputed odd powers of base. The reduction depends on m: a
+//one-limb modulus is handled with machine words, odd ones in Montgomery form, even ones by Barrett reduction; all
+//buffers are allocated once per call.
+big_integer powmod(big_integer_view base, big_integer_view exp, big_integer_view m);
+big_integer powmod(const big_integer &base, const big_integer &exp, const big_integer &m);
+
+//a^-1 mod m in [0, m) for m > 1, through the extended GCD; 0 when a and m aren't coprime
+big_integer invmod(big_integer_view a, big_integer_view m);
+big_integer invmod(const big_integer &a, const big_integer &m);
+
+//the x in [0, M) with x = residues[i] mod moduli[i], M being the product of the moduli. Pre: the moduli are
+//pairwise coprime and positive. Garner's mixed radix form for a handful of moduli, otherwise every residue is
+//weighted by (M / moduli[i])^-1 mod moduli[i] found with a remainder tree and summed up along the product tree
+big_integer crt_combine(const std::vector<uint32_t> &residues, const std::vector<uint32_t> &moduli);
+
+//Arithmetic modulo a fixed odd m > 1 in Montgomery form: x is kept as x * R mod m with R = 2^(32n) for an n-limb m,
+//so that reducing a product needs n multiply-adds instead of a division.
+class montgomery_context
+{
+public:
+    explicit montgomery_context(big_integer_view m); //Pre: m is odd and greater than 1
+
+    const big_integer &modulus() const;
+
+    //a may be any value, it's reduced first
+    big_integer to_montgomery(big_integer_view a) const;
+    //the rest take and return Montgomery forms
+    big_integer from_montgomery(big_integer_view a) const;
+    big_integer mul(big_integer_view a, big_integer_view b) const;
+    big_integer sqr(big_integer_view a) const;
+    big_integer pow(big_integer_view a, big_integer_view e) const; //Pre: e >= 0
+
+    //the same on raw limbs for hot loops: every operand has size() limbs and is below m, r may be any of the
+    //operands, scratch holds scratch_size() limbs
+    size_t size() const;
+    size_t scratch_size() const;
+    void to_montgomery(uint32_t *r, const uint32_t *a, uint32_t *scratch) const;
+    void from_montgomery(uint32_t *r, const uint32_t *a, uint32_t *scratch) const;
+    void mul(uint32_t *r, const uint32_t *a, const uint32_t *b, uint32_t *scratch) const;
+    void sqr(uint32_t *r, const uint32_t *a, uint32_t *scratch) const;
+
+private:
+    big_integer m;
+    std::vector<uint32_t> limbs; //m without the sign limb
+    std::vector<uint32_t> r2; //R^2 mod m, to_montgomery is a multiplication by it
+    uint32_t minv; //-m^-1 mod 2^32
+
+    void load(uint32_t *r, big_integer_view a) const;
+    big_integer store(const uint32_t *a) const;
+};
+
+//Reduction modulo a fixed m > 0 of any parity with two multiplications and at most two subtractions instead of a
+//division: mu = floor(2^(64n) / m) for an n-limb m is computed once, after that anything below 2^(64n), like the
+//product of two residues, is reduced directly and longer values n limbs at a time.
+class barrett_reducer
+{
+public:
+    explicit barrett_reducer(big_integer_view m); //Pre: m > 0
+
+    const big_integer &modulus() const;
+
+    //a % m, with the same sign rules as the operator
+    big_integer reduce(big_integer_view a) const;
+
+    //raw limbs: residues have size() limbs, r may be any of the operands, scratch holds scratch_size() limbs
+    size_t size() const;
+    size_t scratch_size() const;
+    void reduce(uint32_t *r, const uint32_t *x, size_t xn, uint32_t *scratch) const; //r = x mod m for any unsigned x
+    void mul(uint32_t *r, const uint32_t *a, const uint32_t *b, uint32_t *scratch) const;
+    void sqr(uint32_t *r, const uint32_t *a, uint32_t *scratch) const;
+
+private:
+    big_integer m;
+    std::vector<uint32_t> limbs; //m without the sign limb
+    std::vector<uint32_t> mu; //floor(2^(64n) / m), n + 1 limbs
+
+    void reduce_2n(uint32_t *r, const uint32_t *x, uint32_t *scratch) const;
+};
+
+inline big_integer powmod(const big_integer &base, const big_integer &exp, const big_integer &m) {
+    return powmod(big_integer_view(base), big_integer_view(exp), big_integer_view(m));
+}
+
+inline big_integer invmod(const big_integer &a, const big_integer &m) {
+    return invmod(big_integer_view(a), big_integer_view(m));
+}
+
+inline const big_integer &montgomery_context::modulus() const {
+    return m;
+}
+
+inline size_t montgomery_context::size() const {
+    return limbs.size();
+}
+
+inline size_t montgomery_context::scratch_size() const {
+    return 2 * limbs.size() + 1;
+}
+
+inline const big_integer &barrett_reducer::modulus() const {
+    return m;
+}
+
+inline size_t barrett_reducer::size() const {
+    return limbs.size();
+}
+
+inline size_t barrett_reducer::scratch_size() const {
+    return 7 * limbs.size() + 4;
+}
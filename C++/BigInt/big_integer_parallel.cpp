@@ -0,0 +1,178 @@
+#include "big_integer_parallel.h"
+#include "big_integer_kernels.h"
+#include <algorithm>
+
+struct thread_pool::job
+{
+    const std::function<void(size_t)> *f;
+    std::atomic<size_t> pending; //indices not done yet
+};
+
+namespace
+{
+    //the pool the current thread works for and its queue there
+    thread_local thread_pool *current_pool = nullptr;
+    thread_local size_t current_queue = 0;
+
+    std::atomic<thread_pool *> default_pool(nullptr);
+    std::unique_ptr<thread_pool> own_pool; //set_thread_count's
+}
+
+const size_t thread_pool::DEFAULT_GRAIN;
+
+thread_pool::thread_pool(unsigned threads, size_t grain) :
+    count(threads ? threads : std::max(std::thread::hardware_concurrency(), 1u)),
+    queues(new queue[count]),
+    grain_limbs(std::max<size_t>(grain, 2)),
+    queued(0),
+    stop(false)
+{
+    for (unsigned i = 0; i + 1 < count; ++i)
+        workers.emplace_back(&thread_pool::worker, this, i);
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep);
+        stop = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers)
+        t.join();
+}
+
+void thread_pool::parallel_for(size_t n, const std::function<void(size_t)> &f) {
+    if (count == 1 || n < 2) {
+        for (size_t i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+    job j;
+    j.f = &f;
+    j.pending = n;
+    const size_t q = own_queue();
+    execute(q, task{ &j, 0, n });
+    //whatever is left of the job is either in the queues or being run by somebody; help with anything meanwhile
+    while (j.pending.load() > 0) {
+        task t;
+        if (pop(q, t) || steal(q, t))
+            execute(q, t);
+        else
+            std::this_thread::yield();
+    }
+}
+
+size_t thread_pool::own_queue() const {
+    return current_pool == this ? current_queue : count - 1;
+}
+
+void thread_pool::push(size_t q, task t) {
+    {
+        std::lock_guard<std::mutex> lock(queues[q].m);
+        queues[q].tasks.push_back(t);
+    }
+    ++queued;
+    //taking the lock orders this against a worker that just found nothing and is about to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleep);
+    }
+    wake.notify_one();
+}
+
+bool thread_pool::pop(size_t q, task &t) {
+    std::lock_guard<std::mutex> lock(queues[q].m);
+    if (queues[q].tasks.empty())
+        return false;
+    t = queues[q].tasks.back();
+    queues[q].tasks.pop_back();
+    --queued;
+    return true;
+}
+
+bool thread_pool::steal(size_t q, task &t) {
+    //the front holds the biggest pieces, the ones split off first
+    for (size_t k = 1; k < count; ++k) {
+        queue &victim = queues[(q + k) % count];
+        std::lock_guard<std::mutex> lock(victim.m);
+        if (victim.tasks.empty())
+            continue;
+        t = victim.tasks.front();
+        victim.tasks.pop_front();
+        --queued;
+        return true;
+    }
+    return false;
+}
+
+void thread_pool::execute(size_t q, task t) {
+    while (t.end - t.begin > 1) {
+        const size_t mid = t.begin + (t.end - t.begin) / 2;
+        push(q, task{ t.j, mid, t.end });
+        t.end = mid;
+    }
+    (*t.j->f)(t.begin);
+    --t.j->pending;
+}
+
+void thread_pool::worker(size_t q) {
+    current_pool = this;
+    current_queue = q;
+    for (;;) {
+        task t;
+        if (pop(q, t) || steal(q, t)) {
+            execute(q, t);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep);
+        wake.wait(lock, [this] { return stop || queued.load() > 0; });
+        if (stop)
+            return;
+    }
+}
+
+thread_pool *default_thread_pool() {
+    return default_pool.load();
+}
+
+void set_default_thread_pool(thread_pool *pool) {
+    default_pool.store(pool);
+}
+
+void set_thread_count(unsigned threads, size_t grain) {
+    set_default_thread_pool(nullptr);
+    own_pool.reset(threads == 1 ? nullptr : new thread_pool(threads, grain));
+    set_default_thread_pool(own_pool.get());
+}
+
+unsigned thread_count() {
+    thread_pool *pool = default_thread_pool();
+    return pool ? pool->threads() : 1;
+}
+
+namespace big_integer_detail
+{
+    void mul_parallel(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn, thread_pool &pool) {
+        if (an < bn) {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        //a few pieces per thread so that a slow one doesn't hold everybody up
+        size_t pieces = std::min<size_t>(4 * pool.threads(), an / pool.grain());
+        if (bn < pool.grain() || pieces < 2 || pool.threads() < 2) {
+            mul_basecase(r, a, an, b, bn);
+            return;
+        }
+        const size_t len = (an + pieces - 1) / pieces;
+        pieces = (an + len - 1) / len;
+        std::vector<uint32_t> part(pieces * (len + bn));
+        pool.parallel_for(pieces, [&](size_t i) {
+            mul_basecase(part.data() + i * (len + bn), a + i * len, std::min(len, an - i * len), b, bn);
+        });
+        //piece i is (a[i * len, ...) * b) << (32 * i * len)
+        std::fill(r, r + an + bn, 0);
+        for (size_t i = 0; i < pieces; ++i) {
+            const size_t n = std::min(len, an - i * len) + bn;
+            add(r + i * len, r + i * len, an + bn - i * len, part.data() + i * (len + bn), n);
+        }
+    }
+}
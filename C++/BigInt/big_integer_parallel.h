@@ -0,0 +1,113 @@
+#pragma once
+
+#include "big_integer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Opt-in multithreading for very large operands. Nothing runs in parallel unless a thread_pool is passed in
+//explicitly or installed with set_default_thread_pool (or set_thread_count); below the pool's grain everything
+//stays serial.
+
+//A work-stealing pool for fork-join parallelism. Every thread has its own deque: it pushes the work it splits off
+//to the back and takes its own work from there, idle threads steal from the front of the others. A thread waiting
+//for its tasks keeps running tasks in the meantime, so recursive algorithms can fork at every level.
+class thread_pool
+{
+public:
+    static const size_t DEFAULT_GRAIN = 512;
+
+    //threads counts the calling thread too, 0 means one per hardware thread. grain is the smallest operand length
+    //in limbs worth a task of its own, anything shorter stays inline
+    explicit thread_pool(unsigned threads = 0, size_t grain = DEFAULT_GRAIN);
+    ~thread_pool();
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    unsigned threads() const;
+    size_t grain() const;
+
+    //calls f(i) for every i in [0, n), returns once all of them are done. The range is halved until single
+    //indices are left and the halves can be stolen, also when called from inside a task
+    void parallel_for(size_t n, const std::function<void(size_t)> &f);
+    //f() and g(), possibly at the same time
+    void parallel_invoke(const std::function<void()> &f, const std::function<void()> &g);
+
+private:
+    struct job;
+    struct task
+    {
+        job *j;
+        size_t begin, end;
+    };
+    struct queue
+    {
+        std::mutex m;
+        std::deque<task> tasks;
+    };
+
+    unsigned count; //threads, the caller included
+    std::vector<std::thread> workers;
+    std::unique_ptr<queue[]> queues; //one per worker and a last one for threads outside the pool
+    size_t grain_limbs;
+    std::atomic<size_t> queued;
+    std::mutex sleep;
+    std::condition_variable wake;
+    bool stop;
+
+    size_t own_queue() const;
+    void push(size_t q, task t);
+    bool pop(size_t q, task &t);
+    bool steal(size_t q, task &t);
+    void execute(size_t q, task t);
+    void worker(size_t q);
+};
+
+//the pool operator* and the other operators use for large operands, nullptr (the default) keeps them serial
+thread_pool *default_thread_pool();
+void set_default_thread_pool(thread_pool *pool);
+
+//replaces the default pool with one of the library's own with the given number of threads and grain; 1 goes back
+//to serial. Not to be called while other threads use the default pool
+void set_thread_count(unsigned threads, size_t grain = thread_pool::DEFAULT_GRAIN);
+//how many threads the default pool has, 1 without one
+unsigned thread_count();
+
+//a * b with the subproducts spread over pool
+big_integer mul(big_integer_view a, big_integer_view b, thread_pool &pool);
+big_integer mul(const big_integer &a, const big_integer &b, thread_pool &pool);
+
+//to_string and from_string with the divide and conquer conversion spread over pool: independent subtrees go to
+//different threads and write to disjoint parts of one buffer. With a default pool set the plain versions (and the
+//string constructor) do the same for numbers several grains long
+std::string to_string(big_integer_view a, int base, thread_pool &pool);
+big_integer from_string(const char *first, const char *last, int base, thread_pool &pool);
+
+namespace big_integer_detail
+{
+    //mul_basecase with the longer operand cut into pieces that are multiplied on the pool and summed up after;
+    //plain mul_basecase if the operands are too short for the pool's grain
+    void mul_parallel(uint32_t *r, const uint32_t *a, size_t an, const uint32_t *b, size_t bn, thread_pool &pool);
+}
+
+inline unsigned thread_pool::threads() const {
+    return count;
+}
+
+inline size_t thread_pool::grain() const {
+    return grain_limbs;
+}
+
+inline void thread_pool::parallel_invoke(const std::function<void()> &f, const std::function<void()> &g) {
+    parallel_for(2, [&](size_t i) { i ? g() : f(); });
+}
+
+inline big_integer mul(const big_integer &a, const big_integer &b, thread_pool &pool) {
+    return mul(big_integer_view(a), big_integer_view(b), pool);
+}
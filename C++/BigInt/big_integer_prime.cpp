@@ -0,0 +1,322 @@
+#include "big_integer_prime.h"
+#include "big_integer_magnitude.h"
+#include "big_integer_modular.h"
+#include "big_integer_roots.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace big_integer_detail;
+
+namespace
+{
+    const uint32_t SMALL_PRIME_LIMIT = 1 << 11;
+    const size_t SIEVE_WINDOW = 1 << 12; //odd candidates sieved at once by next_prime
+
+    //one generator per thread, seeded from std::random_device the first time it's used; reading the device on every
+    //test would cost more than the test itself on small numbers
+    std::mt19937 &base_generator() {
+        thread_local std::mt19937 gen = [] {
+            std::random_device rd;
+            std::seed_seq seed{ rd(), rd(), rd(), rd() };
+            return std::mt19937(seed);
+        }();
+        return gen;
+    }
+
+    struct small_prime_table
+    {
+        std::vector<uint32_t> primes; //the odd primes below SMALL_PRIME_LIMIT
+        //the primes are split into runs whose product fits into a limb: a remainder by the product is one pass
+        //over the number, the remainders by the primes of the run are word operations from there
+        std::vector<uint32_t> run_product;
+        std::vector<size_t> run_end;
+        std::vector<uint32_t> primorial; //the product of all of them
+
+        small_prime_table() {
+            std::vector<bool> composite(SMALL_PRIME_LIMIT);
+            for (uint32_t i = 3; i < SMALL_PRIME_LIMIT; i += 2) {
+                if (composite[i])
+                    continue;
+                primes.push_back(i);
+                for (uint32_t j = i * i; j < SMALL_PRIME_LIMIT; j += 2 * i)
+                    composite[j] = true;
+            }
+            uint64_t product = 1;
+            for (size_t i = 0; i < primes.size(); ++i) {
+                if (product * primes[i] > UINT32_MAX) {
+                    run_product.push_back((uint32_t)product);
+                    run_end.push_back(i);
+                    product = 1;
+                }
+                product *= primes[i];
+            }
+            run_product.push_back((uint32_t)product);
+            run_end.push_back(primes.size());
+
+            primorial.push_back(1);
+            for (uint32_t p : run_product) {
+                uint32_t carry = mul_1(primorial.data(), primorial.data(), primorial.size(), p);
+                if (carry)
+                    primorial.push_back(carry);
+            }
+        }
+    };
+
+    const small_prime_table &small_primes() {
+        static const small_prime_table table;
+        return table;
+    }
+
+    //res[i] = a[0, n) mod primes[i]
+    void small_residues(const uint32_t *a, size_t n, std::vector<uint32_t> &res) {
+        const small_prime_table &t = small_primes();
+        std::vector<uint32_t> q, r;
+        const size_t pn = t.primorial.size();
+        if (n > pn) {
+            q.resize(n - pn + 1);
+            r.resize(pn);
+            divrem(q.data(), r.data(), a, n, t.primorial.data(), pn);
+            a = r.data();
+            n = pn;
+        }
+        res.resize(t.primes.size());
+        size_t i = 0;
+        for (size_t run = 0; run < t.run_product.size(); ++run) {
+            uint32_t x = mod_1(a, n, t.run_product[run]);
+            for (; i < t.run_end[run]; ++i)
+                res[i] = x % t.primes[i];
+        }
+    }
+
+    //Jacobi symbol (a / n) for an odd n
+    int jacobi(uint32_t a, uint32_t n) {
+        int sign = 1;
+        a %= n;
+        while (a) {
+            while (!(a & 1)) {
+                a >>= 1;
+                if ((n & 7) == 3 || (n & 7) == 5)
+                    sign = -sign;
+            }
+            std::swap(a, n);
+            if ((a & 3) == 3 && (n & 3) == 3)
+                sign = -sign;
+            a %= n;
+        }
+        return n == 1 ? sign : 0;
+    }
+
+    //the strong tests for an odd n without small factors, on raw limbs in Montgomery form
+    class prime_tester
+    {
+    public:
+        explicit prime_tester(big_integer_view n) :
+            ctx(n),
+            k(ctx.size()),
+            scratch(ctx.scratch_size())
+        {
+            magnitude(n, m);
+            magnitude(ctx.to_montgomery(big_integer(1)), one);
+            one.resize(k);
+            minus_one.resize(k);
+            sub_n(minus_one.data(), m.data(), one.data(), k);
+            d = ctx.modulus() - 1;
+            s = (int)trailing_zeros(big_integer_view(d).data());
+            d >>= s;
+        }
+
+        //Pre: 1 < base < n - 1
+        bool miller_rabin(big_integer_view base) {
+            std::vector<uint32_t> x;
+            magnitude(ctx.pow(ctx.to_montgomery(base), d), x);
+            x.resize(k);
+            if (x == one || x == minus_one)
+                return true;
+            for (int i = 1; i < s; ++i) {
+                ctx.sqr(x.data(), x.data(), scratch.data());
+                if (x == minus_one)
+                    return true;
+                if (x == one)
+                    return false;
+            }
+            return false;
+        }
+
+        bool random_miller_rabin(unsigned rounds) {
+            //fresh bases every call, a composite built to fool a fixed set of them would pass every time
+            std::mt19937 &gen = base_generator();
+            std::vector<uint32_t> r(k);
+            const big_integer range = ctx.modulus() - 3;
+            for (unsigned i = 0; i < rounds; ++i) {
+                for (uint32_t &x : r)
+                    x = (uint32_t)gen();
+                if (!miller_rabin(from_magnitude(r.data(), k) % range + 2))
+                    return false;
+            }
+            return true;
+        }
+
+        //with Selfridge's parameters: the first D of 5, -7, 9, -11, ... with (D / n) = -1, P = 1, Q = (1 - D) / 4
+        bool strong_lucas() {
+            const uint32_t n4 = m[0] & 3;
+            int d = 5;
+            for (;;) {
+                const uint32_t ad = (uint32_t)std::abs(d);
+                int j = jacobi(mod_1(m.data(), k, ad), ad);
+                if ((ad & 3) == 3 && n4 == 3)
+                    j = -j;
+                if (d < 0 && n4 == 3)
+                    j = -j;
+                if (j == 0)
+                    return false; //n is far bigger than ad, so this is a proper factor
+                if (j == -1)
+                    break;
+                if (ad == 17 && is_square())
+                    return false; //no D would be found
+                d = d > 0 ? -d - 2 : -d + 2;
+            }
+            std::vector<uint32_t> dm, q, u(one), v(one), qk, t(k), w(k);
+            magnitude(ctx.to_montgomery(big_integer(d)), dm);
+            magnitude(ctx.to_montgomery(big_integer((1 - d) / 4)), q);
+            dm.resize(k);
+            q.resize(k);
+            qk = q;
+
+            //U and V at e = (n + 1) / 2^s, going through its bits from the top
+            big_integer e = ctx.modulus() + 1;
+            const int es = (int)trailing_zeros(big_integer_view(e).data());
+            e >>= es;
+            std::vector<uint32_t> em;
+            magnitude(e, em);
+            for (size_t bit = bit_length(em.data(), em.size()) - 1; bit-- > 0; ) {
+                //U_2j = U_j V_j, V_2j = V_j^2 - 2 Q^j
+                ctx.mul(u.data(), u.data(), v.data(), scratch.data());
+                double_step(v, qk);
+                if (em[bit / 32] >> (bit % 32) & 1) {
+                    //U_j+1 = (U_j + V_j) / 2, V_j+1 = (D U_j + V_j) / 2
+                    ctx.mul(w.data(), dm.data(), u.data(), scratch.data());
+                    add_mod(t.data(), u.data(), v.data());
+                    add_mod(w.data(), w.data(), v.data());
+                    half_mod(u.data(), t.data());
+                    half_mod(v.data(), w.data());
+                    ctx.mul(qk.data(), qk.data(), q.data(), scratch.data());
+                }
+            }
+            if (is_zero(u) || is_zero(v))
+                return true;
+            for (int i = 1; i < es; ++i) {
+                double_step(v, qk);
+                if (is_zero(v))
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        montgomery_context ctx;
+        size_t k;
+        std::vector<uint32_t> scratch, m, one, minus_one;
+        big_integer d; //n - 1 = d * 2^s with an odd d
+        int s;
+
+        //v = v^2 - 2 qk, qk = qk^2
+        void double_step(std::vector<uint32_t> &v, std::vector<uint32_t> &qk) {
+            ctx.sqr(v.data(), v.data(), scratch.data());
+            sub_mod(v.data(), v.data(), qk.data());
+            sub_mod(v.data(), v.data(), qk.data());
+            ctx.sqr(qk.data(), qk.data(), scratch.data());
+        }
+
+        void add_mod(uint32_t *r, const uint32_t *a, const uint32_t *b) const {
+            if (add_n(r, a, b, k) || cmp(r, m.data(), k) >= 0)
+                sub_n(r, r, m.data(), k);
+        }
+
+        void sub_mod(uint32_t *r, const uint32_t *a, const uint32_t *b) const {
+            if (sub_n(r, a, b, k))
+                add_n(r, r, m.data(), k);
+        }
+
+        void half_mod(uint32_t *r, const uint32_t *a) const {
+            //an odd a becomes a + m first, which is even
+            uint32_t carry = 0;
+            if (a[0] & 1) {
+                carry = add_n(r, a, m.data(), k);
+                a = r;
+            }
+            rshift(r, a, k, 1);
+            r[k - 1] |= carry << 31;
+        }
+
+        static bool is_zero(const std::vector<uint32_t> &a) {
+            return strip(a.data(), a.size()) == 0;
+        }
+
+        bool is_square() const {
+            big_integer rem;
+            sqrtrem(ctx.modulus(), rem);
+            return rem == 0;
+        }
+    };
+
+    //Pre: n is odd, above SMALL_PRIME_LIMIT^2 and has no factor below SMALL_PRIME_LIMIT
+    bool strong_probable_prime(big_integer_view n, unsigned rounds, primality_test test) {
+        prime_tester tester(n);
+        if (test == primality_test::bpsw && !(tester.miller_rabin(big_integer(2)) && tester.strong_lucas()))
+            return false;
+        return tester.random_miller_rabin(rounds);
+    }
+}
+
+bool is_probable_prime(big_integer_view n, unsigned rounds, primality_test test) {
+    std::vector<uint32_t> a;
+    magnitude(n, a);
+    if (n.negative() || a.empty() || (a.size() == 1 && a[0] < 3))
+        return !n.negative() && a.size() == 1 && a[0] == 2;
+    if (!(a[0] & 1))
+        return false;
+    const small_prime_table &t = small_primes();
+    std::vector<uint32_t> res;
+    small_residues(a.data(), a.size(), res);
+    for (size_t i = 0; i < res.size(); ++i)
+        if (res[i] == 0)
+            return a.size() == 1 && a[0] == t.primes[i];
+    if (a.size() == 1 && a[0] < SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT)
+        return true;
+    return strong_probable_prime(n, rounds, test);
+}
+
+big_integer next_prime(big_integer_view n, unsigned rounds, primality_test test) {
+    const small_prime_table &t = small_primes();
+    if (n < big_integer(2))
+        return 2;
+    if (n < big_integer(t.primes.back()))
+        return *std::upper_bound(t.primes.begin(), t.primes.end(), big_integer_view(n).data()[0]);
+
+    //every candidate is above the small primes, so whatever they divide is composite
+    big_integer c = big_integer(n) + 1;
+    if (!(big_integer_view(c).data()[0] & 1))
+        c += 1;
+    std::vector<uint32_t> a, res;
+    std::vector<bool> composite;
+    for (;; c += big_integer((int)(2 * SIEVE_WINDOW))) {
+        magnitude(c, a);
+        small_residues(a.data(), a.size(), res);
+        composite.assign(SIEVE_WINDOW, false);
+        for (size_t i = 0; i < res.size(); ++i) {
+            //c + 2j = 0 mod p for j = -res / 2 mod p
+            const uint32_t p = t.primes[i];
+            for (size_t j = (uint64_t)(p - res[i]) % p * ((p + 1) / 2) % p; j < SIEVE_WINDOW; j += p)
+                composite[j] = true;
+        }
+        for (size_t j = 0; j < SIEVE_WINDOW; ++j) {
+            if (composite[j])
+                continue;
+            big_integer candidate = c + big_integer((int)(2 * j));
+            if (candidate < big_integer(SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT)
+                || strong_probable_prime(candidate, rounds, test))
+                return candidate;
+        }
+    }
+}
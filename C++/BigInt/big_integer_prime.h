@@ -0,0 +1,31 @@
+#pragma once
+
+#include "big_integer.h"
+
+enum class primality_test
+{
+    miller_rabin, //rounds of Miller-Rabin with new random bases on every call (from a per-thread generator seeded
+                  //from std::random_device), a composite survives each with probability below 1/4
+    bpsw //Miller-Rabin to base 2 and a strong Lucas test (Baillie-PSW), no known composite passes it
+};
+
+//false if n is certainly composite (or below 2), true if it's prime with high probability; below 2^22 the answer
+//is exact. Small factors are found with trial division by every prime below 2^11, using one long division by their
+//product and word sized remainders after that. The survivors go through the strong tests in Montgomery form; with
+//bpsw the rounds of random bases come on top of it.
+bool is_probable_prime(big_integer_view n, unsigned rounds = 25, primality_test test = primality_test::miller_rabin);
+bool is_probable_prime(const big_integer &n, unsigned rounds = 25,
+                       primality_test test = primality_test::miller_rabin);
+
+//the smallest probable prime greater than n; the candidates are sieved by the small primes first
+big_integer next_prime(big_integer_view n, unsigned rounds = 25, primality_test test = primality_test::miller_rabin);
+big_integer next_prime(const big_integer &n, unsigned rounds = 25,
+                       primality_test test = primality_test::miller_rabin);
+
+inline bool is_probable_prime(const big_integer &n, unsigned rounds, primality_test test) {
+    return is_probable_prime(big_integer_view(n), rounds, test);
+}
+
+inline big_integer next_prime(const big_integer &n, unsigned rounds, primality_test test) {
+    return next_prime(big_integer_view(n), rounds, test);
+}
@@ -0,0 +1,141 @@
+#include "big_integer_product.h"
+#include <algorithm>
+
+namespace
+{
+    size_t limbs(const big_integer &a) {
+        return big_integer_view(a).size();
+    }
+
+    //with a pool the factors are split into two halves of about the same length instead, the halves are
+    //multiplied out side by side and the two results on the pool again
+    big_integer product_fork(big_integer *f, size_t n, thread_pool &pool) {
+        size_t total = 0;
+        for (size_t i = 0; i < n; ++i)
+            total += limbs(f[i]);
+        if (n == 1)
+            return std::move(f[0]);
+        if (total < 2 * pool.grain()) {
+            std::vector<big_integer> part(std::make_move_iterator(f), std::make_move_iterator(f + n));
+            return big_integer_detail::product_tree(part, nullptr);
+        }
+        size_t k = 1, half = limbs(f[0]);
+        while (k + 1 < n && 2 * (half + limbs(f[k])) <= total)
+            half += limbs(f[k++]);
+        big_integer low, high;
+        pool.parallel_invoke([&] { low = product_fork(f, k, pool); },
+                             [&] { high = product_fork(f + k, n - k, pool); });
+        return mul(low, high, pool);
+    }
+}
+
+namespace big_integer_detail
+{
+    big_integer product_tree(std::vector<big_integer> &factors) {
+        return product_tree(factors, default_thread_pool());
+    }
+
+    big_integer product_tree(std::vector<big_integer> &factors, thread_pool *pool) {
+        if (factors.empty())
+            return 1;
+        if (pool && pool->threads() > 1)
+            return product_fork(factors.data(), factors.size(), *pool);
+        //a min-heap by length
+        auto longer = [](const big_integer &a, const big_integer &b) {
+            return limbs(a) > limbs(b);
+        };
+        std::make_heap(factors.begin(), factors.end(), longer);
+        while (factors.size() > 1) {
+            std::pop_heap(factors.begin(), factors.end(), longer);
+            big_integer a = std::move(factors.back());
+            factors.pop_back();
+            std::pop_heap(factors.begin(), factors.end(), longer);
+            factors.back() *= a;
+            std::push_heap(factors.begin(), factors.end(), longer);
+        }
+        return std::move(factors[0]);
+    }
+}
+
+namespace
+{
+    std::vector<uint32_t> primes_up_to(unsigned n) {
+        std::vector<bool> composite(n + 1);
+        std::vector<uint32_t> primes;
+        for (uint64_t i = 2; i <= n; ++i) {
+            if (composite[i])
+                continue;
+            primes.push_back((uint32_t)i);
+            for (uint64_t j = i * i; j <= n; j += i)
+                composite[j] = true;
+        }
+        return primes;
+    }
+
+    //collects small factors, packing as many of them into one limb as fit
+    class factor_list
+    {
+    public:
+        factor_list() :
+            acc(1) {
+        }
+
+        void push(uint32_t p, unsigned times) {
+            for (unsigned i = 0; i < times; ++i) {
+                if (acc * p > UINT32_MAX) {
+                    factors.push_back(big_integer((uint32_t)acc));
+                    acc = 1;
+                }
+                acc *= p;
+            }
+        }
+
+        big_integer product() {
+            if (acc != 1)
+                factors.push_back(big_integer((uint32_t)acc));
+            acc = 1;
+            return big_integer_detail::product_tree(factors);
+        }
+
+    private:
+        uint64_t acc;
+        std::vector<big_integer> factors;
+    };
+
+    //n! / ((n / 2)!)^2: p appears once for every odd floor(n / p^i)
+    big_integer swing(unsigned n, const std::vector<uint32_t> &primes) {
+        factor_list f;
+        for (size_t i = 0; i < primes.size() && primes[i] <= n; ++i) {
+            unsigned e = 0;
+            for (unsigned q = n / primes[i]; q > 0; q /= primes[i])
+                e += q & 1;
+            f.push(primes[i], e);
+        }
+        return f.product();
+    }
+
+    big_integer factorial_swing(unsigned n, const std::vector<uint32_t> &primes) {
+        if (n < 2)
+            return 1;
+        return pow(factorial_swing(n / 2, primes), 2) * swing(n, primes);
+    }
+}
+
+big_integer factorial(unsigned n) {
+    return factorial_swing(n, primes_up_to(n));
+}
+
+big_integer binomial(unsigned n, unsigned k) {
+    if (k > n)
+        return 0;
+    k = std::min(k, n - k);
+    factor_list f;
+    for (uint32_t p : primes_up_to(n)) {
+        //the power of p is the number of carries when adding k and n - k in base p
+        unsigned e = 0;
+        for (uint64_t pp = p; pp <= n; pp *= p)
+            e += (unsigned)(n / pp - k / pp - (n - k) / pp);
+        f.push(p, e);
+    }
+    return f.product();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "big_integer.h"
+#include "big_integer_parallel.h"
+#include <vector>
+
+namespace big_integer_detail
+{
+    //multiplies all of factors together, always the two shortest ones first; factors is used up. With a pool
+    //(by default the default one) the halves of the list are multiplied out side by side
+    big_integer product_tree(std::vector<big_integer> &factors);
+    big_integer product_tree(std::vector<big_integer> &factors, thread_pool *pool);
+}
+
+//the product of [first, last), 1 for an empty range. Instead of going left to right, the two shortest partial
+//products are always multiplied first, so every multiplication gets operands of about the same size
+template <class InputIt>
+big_integer product(InputIt first, InputIt last) {
+    std::vector<big_integer> factors;
+    for (; first != last; ++first)
+        factors.push_back(big_integer(*first));
+    return big_integer_detail::product_tree(factors);
+}
+
+//n! through the prime swing: n! = ((n / 2)!)^2 * swing(n), where swing(n) is put together from its prime
+//factorization and multiplied as a product tree
+big_integer factorial(unsigned n);
+
+//n choose k from its prime factorization (Kummer), 0 for k > n
+big_integer binomial(unsigned n, unsigned k);
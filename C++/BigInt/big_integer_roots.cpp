@@ -0,0 +1,88 @@
+#include "big_integer_roots.h"
+#include "big_integer_magnitude.h"
+#include <cmath>
+
+using namespace big_integer_detail;
+
+namespace
+{
+    uint64_t isqrt_64(uint64_t n) {
+        uint64_t s = (uint64_t)std::sqrt((double)n); //off by a little at most
+        if (s > UINT32_MAX)
+            s = UINT32_MAX;
+        while (s * s > n)
+            --s;
+        while (s < UINT32_MAX && (s + 1) * (s + 1) <= n)
+            ++s;
+        return s;
+    }
+
+    big_integer sqrt_newton(const big_integer &a, big_integer &rem) { //Pre: a >= 0
+        size_t bits = bit_length(a);
+        if (bits <= 64) {
+            uint64_t x = to_64(a), s = isqrt_64(x);
+            rem = from_64(x - s * s);
+            return from_64(s);
+        }
+        //the root of the top half is good to about half of the bits, a Newton step from below doubles that and
+        //lands at most a couple above the answer
+        size_t h = bits / 4;
+        big_integer s = sqrt_newton(a >> (int)(2 * h), rem) << (int)h;
+        s = (s + a / s) >> 1;
+        rem = a - s * s;
+        while (rem < 0) {
+            rem += 2 * s - 1;
+            --s;
+        }
+        return s;
+    }
+
+    //one Newton step for x^k = a, rounded down
+    big_integer root_step(const big_integer &a, const big_integer &x, unsigned k) {
+        return ((int)(k - 1) * x + a / pow(x, k - 1)) / (int)k;
+    }
+
+    big_integer root_newton(const big_integer &a, unsigned k) { //Pre: a > 0, k >= 2
+        size_t bits = bit_length(a), h = bits / (2 * k);
+        big_integer x;
+        if (bits <= 64 || h == 0) {
+            x = big_integer(1) << (int)(bits / k + 1); //surely above the root
+        }
+        else {
+            //below the root and right in the top half of the bits; one step gets above it
+            x = root_newton(a >> (int)(k * h), k) << (int)h;
+            x = root_step(a, x, k);
+        }
+        //from above the integer iteration decreases until it reaches the root
+        for (;;) {
+            big_integer y = root_step(a, x, k);
+            if (y >= x)
+                return x;
+            x = std::move(y);
+        }
+    }
+}
+
+big_integer isqrt(big_integer_view a) {
+    big_integer rem;
+    return sqrtrem(a, rem);
+}
+
+big_integer sqrtrem(big_integer_view a, big_integer &rem) {
+    if (a.negative()) {
+        rem = 0;
+        return 0;
+    }
+    return sqrt_newton(big_integer(a), rem);
+}
+
+big_integer iroot(big_integer_view a, unsigned k) {
+    big_integer x(a);
+    if (k == 1 || x == 0)
+        return x;
+    if (x < 0)
+        return k % 2 ? -root_newton(-x, k) : big_integer(0);
+    if (k == 2)
+        return isqrt(x);
+    return root_newton(x, k);
+}
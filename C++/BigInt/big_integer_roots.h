@@ -0,0 +1,30 @@
+#pragma once
+
+#include "big_integer.h"
+
+//Newton's method with a guess from the root of the top half of the bits, so every level of the recursion doubles
+//the precision and costs about one division of its own size.
+
+//floor(sqrt(a)). Pre: a >= 0
+big_integer isqrt(big_integer_view a);
+big_integer isqrt(const big_integer &a);
+
+//floor(sqrt(a)), rem gets a - floor(sqrt(a))^2. Pre: a >= 0
+big_integer sqrtrem(big_integer_view a, big_integer &rem);
+big_integer sqrtrem(const big_integer &a, big_integer &rem);
+
+//the k-th root of a rounded towards zero. Pre: k >= 1, a >= 0 for an even k
+big_integer iroot(big_integer_view a, unsigned k);
+big_integer iroot(const big_integer &a, unsigned k);
+
+inline big_integer isqrt(const big_integer &a) {
+    return isqrt(big_integer_view(a));
+}
+
+inline big_integer sqrtrem(const big_integer &a, big_integer &rem) {
+    return sqrtrem(big_integer_view(a), rem);
+}
+
+inline big_integer iroot(const big_integer &a, unsigned k) {
+    return iroot(big_integer_view(a), k);
+}
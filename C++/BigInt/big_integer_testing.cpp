@@ -1,11 +1,46 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
 #include <vector>
 #include <utility>
 #include "gtest/gtest.h"
 
 #include "big_integer.h"
+#include "fixed_big_integer.h"
+#include "big_integer_literal.h"
+#include "big_integer_file.h"
+#include "big_integer_modular.h"
+#include "big_integer_gcd.h"
+#include "big_integer_roots.h"
+#include "big_integer_product.h"
+#include "big_integer_prime.h"
+#include "big_integer_parallel.h"
+#include "big_integer_batch.h"
+
+//every limb array goes through here, so a test can tell whether an operation allocated
+static std::atomic<size_t> array_allocations(0);
+
+void *operator new[](size_t n) {
+    ++array_allocations;
+    void *p = std::malloc(n ? n : 1);
+    if (!p)
+        std::abort();
+    return p;
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
 
 TEST(correctness, two_plus_two)
 {
@@ -73,6 +108,87 @@ TEST(correctness, self_assignment)
     EXPECT_TRUE(a == 5);
 }
 
+TEST(correctness, move_ctor)
+{
+    big_integer a("100000000000000000000000000000");
+    big_integer b = std::move(a);
+    a = 5;
+
+    EXPECT_EQ(b, big_integer("100000000000000000000000000000"));
+    EXPECT_EQ(a, 5);
+}
+
+TEST(correctness, moved_from_reuse)
+{
+    big_integer a("100000000000000000000000000000");
+    big_integer b = std::move(a);
+    EXPECT_EQ(a, 0);
+    EXPECT_TRUE(a < b);
+
+    a += b;
+    EXPECT_EQ(a, b);
+
+    big_integer c = std::move(a);
+    const char s[] = "123456789012345678901234567890";
+    from_chars(s, s + sizeof(s) - 1, a);
+    EXPECT_EQ(a, big_integer(s));
+
+    //every in-place write has to give a moved-from value its own limb first; move assignment swaps, so the
+    //value is moved out by construction
+    auto move_out = [](big_integer &x) { big_integer sink(std::move(x)); };
+    move_out(a);
+    a -= 5;
+    EXPECT_EQ(a, -5);
+    move_out(a);
+    a |= 6;
+    EXPECT_EQ(a, 6);
+    move_out(a);
+    a ^= -1;
+    EXPECT_EQ(a, -1);
+    move_out(a);
+    a &= 7;
+    EXPECT_EQ(a, 0);
+    move_out(a);
+    a >>= 3;
+    EXPECT_EQ(a, 0);
+    move_out(a);
+    a <<= 40;
+    EXPECT_EQ(a, 0);
+    move_out(a);
+    EXPECT_EQ(andnot(std::move(a), 1), 0);
+    EXPECT_EQ(a, 0);
+    a = b;
+    EXPECT_EQ(a, b);
+}
+
+TEST(correctness, move_does_not_allocate)
+{
+    big_integer a("100000000000000000000000000000");
+    const size_t before = array_allocations;
+    big_integer b = std::move(a);
+    big_integer c = std::move(a); //moving a moved-from value again
+    std::swap(b, c);
+    a = std::move(c);
+    auto pass = [](big_integer x) { return x; };
+    big_integer d = pass(std::move(a));
+    EXPECT_EQ(array_allocations, before);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 0);
+    EXPECT_EQ(c, 0);
+    EXPECT_EQ(d, big_integer("100000000000000000000000000000"));
+}
+
+TEST(correctness, small_overflow)
+{
+    big_integer a = std::numeric_limits<int>::max();
+    big_integer b = std::numeric_limits<int>::min();
+
+    EXPECT_EQ(a + 1, big_integer("2147483648"));
+    EXPECT_EQ(b - 1, big_integer("-2147483649"));
+    EXPECT_TRUE(b < a);
+    EXPECT_TRUE(b - 1 < b);
+}
+
 TEST(correctness, assignment_return_value)
 {
     big_integer a = 4;
@@ -583,6 +699,51 @@ TEST(correctness, string_conv)
 }
 
 
+TEST(correctness, string_conv_bases)
+{
+    big_integer a = big_integer(1) << 100;
+
+    EXPECT_EQ(to_string(a, 10), "1267650600228229401496703205376");
+    EXPECT_EQ(to_string(a, 16), "10000000000000000000000000");
+    EXPECT_EQ(to_string(-a - 1, 2), "-1" + std::string(99, '0') + "1");
+    EXPECT_EQ(to_string(a, 32), "1" + std::string(20, '0'));
+    EXPECT_EQ(to_string(a, 36), "3ewfdnca0n6ld1ggvfgg");
+    EXPECT_EQ(to_string(big_integer(0), 16), "0");
+    EXPECT_EQ(from_string("-DeadBeef", 16), -big_integer(3735928559u));
+    EXPECT_EQ(from_string("3ewfdnca0n6ld1ggvfgg", 36), a);
+    EXPECT_EQ(from_string("+777", 8), 511);
+}
+
+TEST(correctness, string_conv_long)
+{
+    std::string s = "1" + std::string(3000, '0');
+    big_integer ten = 10;
+    big_integer p = 1;
+    for (int i = 0; i != 3000; ++i)
+        p *= ten;
+
+    EXPECT_EQ(big_integer(s), p);
+    EXPECT_EQ(to_string(p), s);
+    EXPECT_EQ(to_string(p - 1), std::string(3000, '9'));
+    EXPECT_EQ(to_string(-p + 1), "-" + std::string(3000, '9'));
+    EXPECT_EQ(from_string(to_string(p, 7), 7), p);
+}
+
+TEST(correctness, string_conv_stream)
+{
+    std::stringstream ss;
+    ss << std::hex << std::showbase << big_integer(-255) << " " << std::uppercase << big_integer(3054) << " "
+       << std::dec << std::noshowbase << big_integer(42);
+    EXPECT_EQ(ss.str(), "-0xff 0XBEE 42");
+
+    big_integer a, b, c;
+    ss >> std::hex >> a >> b >> std::dec >> c;
+    EXPECT_EQ(a, -255);
+    EXPECT_EQ(b, 3054);
+    EXPECT_EQ(c, 42);
+}
+
+
 namespace
 {
     unsigned const number_of_iterations = 10;
@@ -680,3 +841,902 @@ TEST(correctness, mul_merge_randomized)
         EXPECT_TRUE(a == b);
     }
 }
+
+namespace
+{
+    big_integer random_big_integer(size_t limbs)
+    {
+        big_integer r = 0;
+        for (size_t i = 0; i != limbs; ++i)
+            r = (r << 32) + big_integer((uint32_t)rand() * 2654435761u + (uint32_t)rand());
+        return rand() % 2 ? r : -r;
+    }
+
+    constexpr fixed_big_integer<256> fixed_square_minus_one(int x)
+    {
+        fixed_big_integer<256> r = x;
+        r *= r;
+        return --r;
+    }
+}
+
+TEST(correctness, fixed_constexpr)
+{
+    constexpr fixed_big_integer<256> a = fixed_square_minus_one(1 << 20);
+    constexpr fixed_big_integer<256> b = (a + 1) / (1 << 10) % 1000000 - 3;
+    static_assert(a == fixed_big_integer<256>(1 << 30) * (1 << 10) - 1, "constexpr multiplication");
+    static_assert(b == 741821, "constexpr division");
+    static_assert((fixed_big_integer<256>(-1) >> 100) == -1, "constexpr arithmetic shift");
+    EXPECT_EQ(to_string(a), "1099511627775");
+}
+
+TEST(correctness, fixed_wraparound)
+{
+    fixed_big_integer<64> max = ~(fixed_big_integer<64>(1) << 63);
+    fixed_big_integer<64> min = fixed_big_integer<64>(1) << 63;
+
+    EXPECT_EQ(max + 1, min);
+    EXPECT_EQ(min - 1, max);
+    EXPECT_EQ(-min, min);
+    EXPECT_TRUE(min < max);
+    EXPECT_EQ(to_string(max), "9223372036854775807");
+    EXPECT_EQ(to_string(min), "-9223372036854775808");
+    EXPECT_EQ(big_integer(min), -(big_integer(1) << 63));
+}
+
+TEST(correctness, fixed_matches_big_integer)
+{
+    for (unsigned itn = 0; itn != 1000; ++itn) {
+        big_integer a = random_big_integer(rand() % 7 + 1);
+        big_integer b = random_big_integer(rand() % 7 + 1);
+        fixed_big_integer<256> fa(a), fb(b);
+
+        EXPECT_EQ(big_integer(fa), a);
+        EXPECT_EQ(fa + fb, fixed_big_integer<256>(a + b));
+        EXPECT_EQ(fa - fb, fixed_big_integer<256>(a - b));
+        EXPECT_EQ(fa * fb, fixed_big_integer<256>(a * b));
+        EXPECT_EQ(fa & fb, fixed_big_integer<256>(a & b));
+        EXPECT_EQ(fa ^ ~fb, fixed_big_integer<256>(a ^ ~b));
+        EXPECT_EQ(fa << 77, fixed_big_integer<256>(a << 77));
+        EXPECT_EQ(fa >> 45, fixed_big_integer<256>(a >> 45));
+        EXPECT_EQ(fa < fb, a < b);
+        if (b != 0) {
+            EXPECT_EQ(big_integer(fa / fb), a / b);
+            EXPECT_EQ(big_integer(fa % fb), a % b);
+        }
+        EXPECT_EQ(to_string(fa), to_string(a));
+    }
+}
+
+using namespace big_integer_literals;
+
+TEST(correctness, literal)
+{
+    big_integer a = 100000000000000000000000000000000000000000000000000_bi;
+    big_integer b = -100000000000000000000000000000000000000000000000000_bi;
+    big_integer c = 0xffffffffffffffffffffffff_bi;
+    big_integer d = 0b1'0000'0000'0000'0000'0000'0000'0000'0000_bi;
+
+    EXPECT_EQ(a, big_integer("100000000000000000000000000000000000000000000000000"));
+    EXPECT_EQ(b, -a);
+    EXPECT_EQ(c, (big_integer(1) << 96) - 1);
+    EXPECT_EQ(d, big_integer(1) << 32);
+    EXPECT_EQ(017_bi + 0_bi, 15);
+    EXPECT_EQ(-2147483648_bi, std::numeric_limits<int>::min());
+    EXPECT_EQ(a * 3_bi, big_integer("300000000000000000000000000000000000000000000000000"));
+}
+
+TEST(correctness, literal_fixed_constexpr)
+{
+    constexpr fixed_big_integer<128> min = -170141183460469231731687303715884105728_bi;
+    constexpr fixed_big_integer<128> max = 0x7fffffffffffffffffffffffffffffff_bi;
+    constexpr fixed_big_integer<64> low = 0x1'0000'0000'0000'0001_bi;
+    static_assert(max + 1 == min, "literal is parsed at compile time");
+    static_assert(low == 1, "literal keeps the lowest bits");
+    EXPECT_EQ(to_string(min), "-170141183460469231731687303715884105728");
+}
+
+TEST(correctness, literal_rejected)
+{
+    //these don't compile: 1.5_bi, 1e3_bi, 0x1p4_bi (floating literals), 08_bi, 0179_bi (8 and 9 aren't octal),
+    //0b102_bi, 0x'1_bi and 0b1'_bi (a ' not between two digits)
+    using big_integer_detail::valid_literal;
+    static_assert(!valid_literal<'1', '.', '5'>(), "1.5_bi");
+    static_assert(!valid_literal<'1', 'e', '3'>(), "1e3_bi");
+    static_assert(!valid_literal<'0', 'x', '1', 'p', '4'>(), "0x1p4_bi");
+    static_assert(!valid_literal<'0', '8'>(), "08_bi");
+    static_assert(!valid_literal<'0', '1', '7', '9'>(), "0179_bi");
+    static_assert(!valid_literal<'0', 'b', '1', '0', '2'>(), "0b102_bi");
+    static_assert(!valid_literal<'0', 'x', '\'', '1'>(), "0x'1_bi");
+    static_assert(!valid_literal<'0', 'b', '1', '\''>(), "0b1'_bi");
+    static_assert(valid_literal<'0', '\'', '1', '7'>(), "0'17_bi is octal 15");
+    static_assert(valid_literal<'0', 'X', 'f', 'F'>(), "0XfF_bi");
+    static_assert(valid_literal<'0'>(), "0_bi");
+    EXPECT_EQ(0'17_bi, 15);
+}
+
+TEST(correctness, string_conv_randomized)
+{
+    for (unsigned itn = 0; itn != 200; ++itn) {
+        big_integer a = random_big_integer(rand() % 200 + 1);
+        int base = rand() % 35 + 2;
+        EXPECT_EQ(from_string(to_string(a, base), base), a);
+        EXPECT_EQ(big_integer(to_string(a)), a);
+    }
+}
+
+TEST(correctness, serialization)
+{
+    std::vector<unsigned char> buf;
+    std::vector<big_integer> values;
+    values.push_back(0);
+    values.push_back(-1);
+    values.push_back(std::numeric_limits<int>::min());
+    for (unsigned itn = 0; itn != 100; ++itn)
+        values.push_back(random_big_integer(rand() % 300 + 1));
+    for (size_t i = 0; i != values.size(); ++i)
+        serialize(values[i], buf);
+
+    EXPECT_EQ(serialized_size(big_integer(5)), 5u);
+    size_t pos = 0;
+    for (size_t i = 0; i != values.size(); ++i) {
+        big_integer a;
+        size_t len = deserialize(buf.data() + pos, buf.size() - pos, a);
+        ASSERT_NE(len, 0u);
+        EXPECT_EQ(a, values[i]);
+        pos += len;
+    }
+    EXPECT_EQ(pos, buf.size());
+
+    big_integer a;
+    const unsigned char truncated[] = { 2, 1, 0, 0, 0, 0, 0 };
+    const unsigned char empty[] = { 0 };
+    EXPECT_EQ(deserialize(truncated, sizeof truncated, a), 0u);
+    EXPECT_EQ(deserialize(empty, sizeof empty, a), 0u);
+}
+
+TEST(correctness, serialization_view)
+{
+    big_integer a = -(big_integer(1) << 1000) + 12345;
+    std::vector<uint32_t> storage(serialized_size(a) / 4 + 2);
+    unsigned char *buf = reinterpret_cast<unsigned char *>(storage.data()) + 3; //so that the limbs are aligned
+    size_t len = serialize(a, buf);
+
+    big_integer_view v;
+    EXPECT_EQ(deserialize(buf, len, v), len);
+    EXPECT_EQ(reinterpret_cast<const unsigned char *>(v.data()), buf + 1);
+    EXPECT_EQ(big_integer(v), a);
+    EXPECT_EQ(to_string(v, 10), to_string(a));
+}
+
+TEST(correctness, view_operands)
+{
+    //not normalized on purpose: -5 sign extended to four limbs, 2^40 with a spare zero limb
+    std::vector<uint32_t> m5 = { (uint32_t)-5, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+    std::vector<uint32_t> p40 = { 0, 1 << 8, 0 };
+    big_integer_view v(m5.data(), m5.size()), w(p40.data(), p40.size());
+    big_integer a = big_integer(1) << 40;
+
+    EXPECT_TRUE(v == big_integer(-5));
+    EXPECT_TRUE(w == a);
+    EXPECT_TRUE(v < w);
+    EXPECT_TRUE(w >= a);
+    EXPECT_FALSE(w != a);
+
+    EXPECT_EQ(a + v, a - 5);
+    EXPECT_EQ(a - v, a + 5);
+    EXPECT_EQ(a * v, a * -5);
+    EXPECT_EQ(v * w, a * -5);
+    EXPECT_EQ(a / v, a / -5);
+    EXPECT_EQ(a % v, a % -5);
+    EXPECT_EQ(a & v, a & -5);
+    EXPECT_EQ(a | v, a | -5);
+    EXPECT_EQ(a ^ v, a ^ -5);
+    EXPECT_EQ(big_integer(123) / w, 0);
+    EXPECT_EQ(big_integer(-123) % w, -123);
+    EXPECT_EQ(to_string(v, 10), "-5");
+
+    big_integer b = a;
+    b *= b;
+    b -= w;
+    b /= w;
+    EXPECT_EQ(b, a - 1);
+}
+
+TEST(correctness, view_operands_randomized)
+{
+    for (int i = 0; i < 200; ++i) {
+        big_integer a = random_big_integer(rand() % 12 + 1), b = random_big_integer(rand() % 12 + 1);
+        if (b == 0)
+            continue;
+        std::vector<unsigned char> buf;
+        serialize(b, buf);
+        big_integer c;
+        deserialize(buf.data(), buf.size(), c);
+        big_integer_view v = c;
+        EXPECT_EQ(a + v, a + b);
+        EXPECT_EQ(a * v, a * b);
+        EXPECT_EQ(a / v, a / b);
+        EXPECT_EQ(a % v, a % b);
+        EXPECT_EQ(a / v * b + a % v, a);
+        EXPECT_EQ(v < a, b < a);
+        EXPECT_EQ(v == a, b == a);
+    }
+}
+
+TEST(correctness, write_string_streamed)
+{
+    big_integer p = 1;
+    for (int i = 0; i < 1000; ++i)
+        p *= 10;
+    big_integer values[] = { 0, -7, p, p - 1, -p + 1, p * p + 1, random_big_integer(200), random_big_integer(333) };
+    for (const big_integer &a : values) {
+        std::ostringstream out;
+        write_string(out, a, 10);
+        EXPECT_EQ(out.str(), to_string(a));
+        std::ostringstream hex;
+        write_string(hex, a, 16);
+        EXPECT_EQ(hex.str(), to_string(a, 16));
+    }
+}
+
+TEST(correctness, decimal_file)
+{
+    const char *path = "big_integer_decimal_file.tmp";
+    big_integer a = -random_big_integer(500) * random_big_integer(100) - 1, b;
+    ASSERT_TRUE(write_decimal_file(path, a));
+    ASSERT_TRUE(read_decimal_file(path, b));
+    EXPECT_EQ(a, b);
+
+    {
+        std::ofstream out(path);
+        out << "  \n+00123456789012345678901234567890\n\n";
+    }
+    ASSERT_TRUE(read_decimal_file(path, b));
+    EXPECT_EQ(b, big_integer("123456789012345678901234567890"));
+
+    {
+        std::ofstream out(path);
+        out << "12 34";
+    }
+    EXPECT_FALSE(read_decimal_file(path, b));
+    EXPECT_EQ(b, big_integer("123456789012345678901234567890"));
+    std::remove(path);
+    EXPECT_FALSE(read_decimal_file(path, b));
+}
+
+TEST(correctness, to_chars_from_chars)
+{
+    big_integer values[] = { 0, 1, -1, INT32_MIN, big_integer(1) << 31, -(big_integer(1) << 100),
+                             random_big_integer(20), random_big_integer(600) };
+    for (const big_integer &a : values)
+        for (int base : { 2, 3, 10, 16, 36 }) {
+            std::string expected = to_string(a, base);
+            std::vector<char> buf(to_chars_size(a, base));
+            EXPECT_GE(buf.size(), expected.size());
+            to_chars_result r = to_chars(buf.data(), buf.data() + buf.size(), a, base);
+            EXPECT_TRUE(r.ec == std::errc());
+            EXPECT_EQ(std::string(buf.data(), r.ptr), expected);
+
+            r = to_chars(buf.data(), buf.data() + expected.size() - 1, a, base);
+            EXPECT_TRUE(r.ec == std::errc::value_too_large);
+            EXPECT_EQ(r.ptr, buf.data() + expected.size() - 1);
+
+            big_integer b = 42;
+            from_chars_result f = from_chars(expected.data(), expected.data() + expected.size(), b, base);
+            EXPECT_TRUE(f.ec == std::errc());
+            EXPECT_EQ(f.ptr, expected.data() + expected.size());
+            EXPECT_EQ(b, a);
+        }
+}
+
+TEST(correctness, from_chars_partial)
+{
+    big_integer a = 7;
+    std::string s = "-123456789012345678901234567890xyz";
+    from_chars_result r = from_chars(s.data(), s.data() + s.size(), a);
+    EXPECT_TRUE(r.ec == std::errc());
+    EXPECT_EQ(r.ptr, s.data() + s.size() - 3);
+    EXPECT_EQ(a, big_integer("-123456789012345678901234567890"));
+
+    s = "ffz";
+    r = from_chars(s.data(), s.data() + s.size(), a, 16);
+    EXPECT_EQ(r.ptr, s.data() + 2);
+    EXPECT_EQ(a, 255);
+
+    for (std::string bad : { "", "-", "+1", " 1", "x" }) {
+        r = from_chars(bad.data(), bad.data() + bad.size(), a);
+        EXPECT_TRUE(r.ec == std::errc::invalid_argument);
+        EXPECT_EQ(r.ptr, bad.data());
+        EXPECT_EQ(a, 255);
+    }
+}
+
+TEST(correctness, chars_bad_base)
+{
+    big_integer a = 255;
+    char buf[16];
+    const std::string s = "101";
+    for (int base : { -2, 0, 1, 37 }) {
+        to_chars_result t = to_chars(buf, buf + sizeof(buf), a, base);
+        EXPECT_TRUE(t.ec == std::errc::invalid_argument);
+        EXPECT_EQ(t.ptr, buf);
+
+        from_chars_result f = from_chars(s.data(), s.data() + s.size(), a, base);
+        EXPECT_TRUE(f.ec == std::errc::invalid_argument);
+        EXPECT_EQ(f.ptr, s.data());
+        EXPECT_EQ(a, 255);
+    }
+
+    //digit_value must not let punctuation through as a digit of a big base
+    for (std::string bad : { "[", "@", "`", "{" }) {
+        from_chars_result f = from_chars(bad.data(), bad.data() + bad.size(), a, 36);
+        EXPECT_TRUE(f.ec == std::errc::invalid_argument);
+    }
+}
+
+TEST(correctness, stream_formatting)
+{
+    std::ostringstream out;
+    out << std::showbase << std::showpos << std::hex << big_integer(255) << ' ' << big_integer(-255) << ' '
+        << std::uppercase << big_integer(255) << ' ' << std::oct << big_integer(8) << ' ' << std::dec
+        << std::noshowpos << std::setw(6) << std::setfill('.') << big_integer(-42);
+    EXPECT_EQ(out.str(), "+0xff -0xff +0XFF +010 ...-42");
+
+    std::ostringstream zero, expected;
+    zero << std::showbase << std::hex << big_integer(0) << ' ' << std::oct << big_integer(0);
+    expected << std::showbase << std::hex << 0 << ' ' << std::oct << 0;
+    EXPECT_EQ(zero.str(), expected.str());
+    EXPECT_EQ(zero.str(), "0 0");
+}
+
+namespace
+{
+    big_integer naive_powmod(big_integer b, big_integer e, const big_integer &m) {
+        big_integer r = 1 % m;
+        b %= m;
+        for (; e > 0; e >>= 1) {
+            if ((e & 1) == 1)
+                r = r * b % m;
+            b = b * b % m;
+        }
+        return r < 0 ? r + m : r;
+    }
+}
+
+TEST(correctness, powmod_small)
+{
+    EXPECT_EQ(powmod(2, 10, 1000), 24);
+    EXPECT_EQ(powmod(-2, 3, 5), 2);
+    EXPECT_EQ(powmod(7, 0, 13), 1);
+    EXPECT_EQ(powmod(7, 0, 1), 0);
+    EXPECT_EQ(powmod(0, 5, 13), 0);
+    EXPECT_EQ(powmod(3, 1000000, 1000000007), 64935414);
+    EXPECT_EQ(powmod(big_integer(1) << 70, 3, big_integer(UINT32_MAX)), naive_powmod(big_integer(1) << 70, 3, UINT32_MAX));
+    //Fermat: a^(p - 1) = 1 for the Mersenne prime 2^127 - 1
+    big_integer p = (big_integer(1) << 127) - 1;
+    EXPECT_EQ(powmod(123456789, p - 1, p), 1);
+}
+
+TEST(correctness, powmod_randomized)
+{
+    for (int i = 0; i < 60; ++i) {
+        big_integer b = random_big_integer(rand() % 10 + 1), e = random_big_integer(rand() % 4 + 1);
+        big_integer m = random_big_integer(rand() % 8 + 1);
+        if (e < 0)
+            e = -e;
+        if (m < 0)
+            m = -m;
+        if (m == 0)
+            continue;
+        EXPECT_EQ(powmod(b, e, m), naive_powmod(b, e, m));
+    }
+}
+
+TEST(correctness, montgomery)
+{
+    for (int i = 0; i < 30; ++i) {
+        big_integer m = random_big_integer(rand() % 6 + 1);
+        if (m < 0)
+            m = -m;
+        m |= 1;
+        if (m == 1)
+            continue;
+        montgomery_context ctx(m);
+        EXPECT_EQ(ctx.modulus(), m);
+        big_integer a = random_big_integer(rand() % 8 + 1), b = random_big_integer(rand() % 8 + 1);
+        big_integer ra = a % m, rb = b % m;
+        if (ra < 0)
+            ra += m;
+        if (rb < 0)
+            rb += m;
+        big_integer ma = ctx.to_montgomery(a), mb = ctx.to_montgomery(b);
+        EXPECT_EQ(ctx.from_montgomery(ma), ra);
+        EXPECT_EQ(ctx.from_montgomery(ctx.mul(ma, mb)), ra * rb % m);
+        EXPECT_EQ(ctx.from_montgomery(ctx.sqr(ma)), ra * ra % m);
+        EXPECT_EQ(ctx.from_montgomery(ctx.pow(ma, big_integer(12345))), naive_powmod(a, 12345, m));
+        EXPECT_EQ(ctx.from_montgomery(ctx.pow(ma, big_integer(0))), 1);
+    }
+}
+
+TEST(correctness, montgomery_raw_limbs)
+{
+    //2^96 - 17: three limbs, the top one all ones
+    big_integer m = (big_integer(1) << 96) - 17;
+    montgomery_context ctx(m);
+    ASSERT_EQ(ctx.size(), 3u);
+    std::vector<uint32_t> x = { 5, 0, 0 }, one = { 1, 0, 0 }, scratch(ctx.scratch_size());
+    ctx.to_montgomery(x.data(), x.data(), scratch.data());
+    ctx.to_montgomery(one.data(), one.data(), scratch.data());
+    std::vector<uint32_t> r = one;
+    for (int i = 0; i < 100; ++i)
+        ctx.mul(r.data(), r.data(), x.data(), scratch.data());
+    ctx.from_montgomery(r.data(), r.data(), scratch.data());
+    r.push_back(0);
+    EXPECT_EQ(big_integer(big_integer_view(r.data(), r.size())), naive_powmod(5, 100, m));
+}
+
+TEST(correctness, barrett)
+{
+    for (int i = 0; i < 40; ++i) {
+        big_integer m = random_big_integer(rand() % 6 + 1);
+        if (m < 0)
+            m = -m;
+        if (m == 0)
+            continue;
+        barrett_reducer red(m);
+        EXPECT_EQ(red.modulus(), m);
+        for (int j = 0; j < 5; ++j) {
+            big_integer a = random_big_integer(rand() % 20 + 1);
+            EXPECT_EQ(red.reduce(a), a % m);
+        }
+        EXPECT_EQ(red.reduce(m * m - 1), m * m - 1 - (m - 1) * m);
+    }
+}
+
+TEST(correctness, barrett_raw_limbs)
+{
+    //2^96 - 2: even, three limbs
+    big_integer m = (big_integer(1) << 96) - 2;
+    barrett_reducer red(m);
+    ASSERT_EQ(red.size(), 3u);
+    std::vector<uint32_t> x = { 5, 0, 0 }, r = { 1, 0, 0 }, scratch(red.scratch_size());
+    for (int i = 0; i < 100; ++i)
+        red.mul(r.data(), r.data(), x.data(), scratch.data());
+    red.sqr(r.data(), r.data(), scratch.data());
+    r.push_back(0);
+    EXPECT_EQ(big_integer(big_integer_view(r.data(), r.size())), naive_powmod(5, 200, m));
+}
+
+namespace
+{
+    big_integer naive_gcd(big_integer a, big_integer b) {
+        if (a < 0)
+            a = -a;
+        if (b < 0)
+            b = -b;
+        while (b != 0) {
+            a %= b;
+            std::swap(a, b);
+        }
+        return a;
+    }
+}
+
+TEST(correctness, gcd_small)
+{
+    EXPECT_EQ(gcd(12, 18), 6);
+    EXPECT_EQ(gcd(-12, 18), 6);
+    EXPECT_EQ(gcd(0, -7), 7);
+    EXPECT_EQ(gcd(0, 0), 0);
+    EXPECT_EQ(lcm(4, -6), 12);
+    EXPECT_EQ(lcm(0, 5), 0);
+    big_integer f1 = 1, f2 = 1; //consecutive Fibonacci numbers are the worst case for Euclid
+    for (int i = 0; i < 500; ++i) {
+        f1 += f2;
+        std::swap(f1, f2);
+    }
+    EXPECT_EQ(gcd(f1, f2), 1);
+    big_integer x, y;
+    EXPECT_EQ(gcdext(f1, f2, x, y), 1);
+    EXPECT_EQ(f1 * x + f2 * y, 1);
+}
+
+TEST(correctness, gcd_randomized)
+{
+    for (int i = 0; i < 100; ++i) {
+        big_integer c = random_big_integer(rand() % 4 + 1);
+        big_integer a = random_big_integer(rand() % 20 + 1) * c, b = random_big_integer(rand() % 20 + 1) * c;
+        big_integer g = gcd(a, b);
+        EXPECT_EQ(g, naive_gcd(a, b));
+        big_integer x, y;
+        EXPECT_EQ(gcdext(a, b, x, y), g);
+        EXPECT_EQ(a * x + b * y, g);
+        if (g != 0) {
+            EXPECT_EQ(lcm(a, b), (a < 0 ? -a : a) / g * (b < 0 ? -b : b));
+        }
+    }
+}
+
+TEST(correctness, invmod)
+{
+    EXPECT_EQ(invmod(3, 7), 5);
+    EXPECT_EQ(invmod(-3, 7), 2);
+    EXPECT_EQ(invmod(6, 9), 0);
+    big_integer p = (big_integer(1) << 127) - 1;
+    for (int i = 0; i < 20; ++i) {
+        big_integer a = random_big_integer(rand() % 8 + 1);
+        if (a % p == 0)
+            continue;
+        big_integer x = invmod(a, p);
+        EXPECT_TRUE(x >= 0 && x < p);
+        big_integer one = a * x % p;
+        EXPECT_EQ(one < 0 ? one + p : one, 1);
+    }
+}
+
+TEST(correctness, crt_combine)
+{
+    std::vector<uint32_t> primes;
+    for (uint32_t c = 2147483647u; primes.size() < 300; c -= 2) {
+        bool prime = true;
+        for (uint32_t d = 3; (uint64_t)d * d <= c && prime; d += 2)
+            prime = c % d != 0;
+        if (prime)
+            primes.push_back(c);
+    }
+    EXPECT_EQ(crt_combine({ 2, 3, 2 }, { 3, 5, 7 }), 23);
+    for (size_t k : { 1, 5, 16, 17, 300 }) {
+        std::vector<uint32_t> m(primes.begin(), primes.begin() + k), r;
+        big_integer product = 1;
+        for (uint32_t x : m)
+            product *= big_integer(x);
+        big_integer x = random_big_integer(k) % product;
+        if (x < 0)
+            x += product;
+        for (uint32_t p : m)
+            r.push_back((uint32_t)std::stoul(to_string(x % big_integer(p))));
+        EXPECT_EQ(crt_combine(r, m), x);
+    }
+}
+
+TEST(correctness, isqrt)
+{
+    EXPECT_EQ(isqrt(0), 0);
+    EXPECT_EQ(isqrt(1), 1);
+    EXPECT_EQ(isqrt(15), 3);
+    EXPECT_EQ(isqrt(16), 4);
+    big_integer rem;
+    EXPECT_EQ(sqrtrem(big_integer(1) << 200, rem), big_integer(1) << 100);
+    EXPECT_EQ(rem, 0);
+    for (int i = 0; i < 60; ++i) {
+        big_integer a = random_big_integer(rand() % 30 + 1);
+        if (a < 0)
+            a = -a;
+        big_integer s = sqrtrem(a, rem);
+        EXPECT_EQ(s * s + rem, a);
+        EXPECT_TRUE(rem >= 0 && rem <= 2 * s);
+        EXPECT_EQ(isqrt(s * s), s);
+        EXPECT_EQ(isqrt(s * s - 1), s - 1);
+    }
+}
+
+TEST(correctness, iroot)
+{
+    EXPECT_EQ(iroot(27, 3), 3);
+    EXPECT_EQ(iroot(26, 3), 2);
+    EXPECT_EQ(iroot(-27, 3), -3);
+    EXPECT_EQ(iroot(5, 1), 5);
+    EXPECT_EQ(iroot(big_integer(1) << 70, 100), 1);
+    for (int i = 0; i < 40; ++i) {
+        big_integer a = random_big_integer(rand() % 20 + 1);
+        if (a < 0)
+            a = -a;
+        unsigned k = rand() % 10 + 2;
+        big_integer r = iroot(a, k), lo = 1, hi = 1;
+        for (unsigned j = 0; j < k; ++j) {
+            lo *= r;
+            hi *= r + 1;
+        }
+        EXPECT_TRUE(lo <= a && a < hi);
+    }
+}
+
+TEST(correctness, pow)
+{
+    EXPECT_EQ(pow(big_integer(3), 0), 1);
+    EXPECT_EQ(pow(big_integer(0), 5), 0);
+    EXPECT_EQ(pow(big_integer(-1), 7), -1);
+    EXPECT_EQ(pow(big_integer(-2), 3), -8);
+    EXPECT_EQ(pow(big_integer(2), 100), big_integer(1) << 100);
+    EXPECT_EQ(pow(big_integer(10), 30), big_integer("1000000000000000000000000000000"));
+    EXPECT_EQ(pow(big_integer(-10), 31), big_integer("-10000000000000000000000000000000"));
+    big_integer c = (big_integer(1) << 32) + 1;
+    EXPECT_EQ(pow(c, 3), c * c * c);
+    for (int i = 0; i < 40; ++i) {
+        big_integer b = i < 10 ? big_integer(rand() % 200 - 100) : random_big_integer(rand() % 4 + 1);
+        if (i % 3 == 0)
+            b <<= rand() % 70;
+        unsigned e = rand() % 40;
+        big_integer expected = 1;
+        for (unsigned j = 0; j < e; ++j)
+            expected *= b;
+        EXPECT_EQ(pow(b, e), expected);
+    }
+}
+
+TEST(correctness, product)
+{
+    std::vector<int> empty;
+    EXPECT_EQ(product(empty.begin(), empty.end()), 1);
+    std::vector<big_integer> x;
+    big_integer expected = 1;
+    for (size_t i = 0; i != number_of_multipliers; ++i) {
+        x.push_back(i % 10 ? big_integer(myrand()) : random_big_integer(rand() % 5 + 1));
+        expected *= x.back();
+    }
+    EXPECT_EQ(product(x.begin(), x.end()), expected);
+    int small[] = { 2, -3, 5, 7 };
+    EXPECT_EQ(product(small, small + 4), -210);
+}
+
+TEST(correctness, factorial_binomial)
+{
+    big_integer f = 1;
+    for (unsigned n = 0; n < 300; ++n) {
+        if (n > 0)
+            f *= n;
+        EXPECT_EQ(factorial(n), f);
+    }
+    EXPECT_EQ(binomial(5, 2), 10);
+    EXPECT_EQ(binomial(5, 7), 0);
+    EXPECT_EQ(binomial(0, 0), 1);
+    EXPECT_EQ(binomial(1000, 500), factorial(1000) / (factorial(500) * factorial(500)));
+    for (unsigned n = 0; n < 40; ++n) {
+        big_integer row = 0;
+        for (unsigned k = 0; k <= n; ++k) {
+            EXPECT_EQ(binomial(n, k), binomial(n, n - k));
+            row += binomial(n, k);
+        }
+        EXPECT_EQ(row, big_integer(1) << n);
+    }
+}
+
+TEST(correctness, is_probable_prime)
+{
+    std::vector<bool> composite(20000);
+    for (int i = 2; i < 20000; ++i) {
+        for (int j = 2 * i; j < 20000; j += i)
+            composite[j] = true;
+        EXPECT_EQ(is_probable_prime(i), !composite[i]);
+    }
+    EXPECT_FALSE(is_probable_prime(0));
+    EXPECT_FALSE(is_probable_prime(1));
+    EXPECT_FALSE(is_probable_prime(-7));
+
+    //past the range trial division decides
+    big_integer m127 = (big_integer(1) << 127) - 1, m521 = (big_integer(1) << 521) - 1;
+    EXPECT_TRUE(is_probable_prime(m127));
+    EXPECT_TRUE(is_probable_prime(m521, 5, primality_test::bpsw));
+    EXPECT_FALSE(is_probable_prime(m127 * m127));
+    EXPECT_FALSE(is_probable_prime(m127 * m521, 0, primality_test::bpsw));
+    EXPECT_FALSE(is_probable_prime((big_integer(1) << 523) - 1));
+    EXPECT_TRUE(is_probable_prime(big_integer(4294967291u)));
+    EXPECT_TRUE(is_probable_prime(big_integer("18446744073709551557")));
+
+    //strong pseudoprimes to base 2 without small factors: 25326001 = 2251 * 3251 * 3461 and
+    //3825123056546413051 = 149491 * 747451 * 34233211, which passes Miller-Rabin for every base up to 23
+    for (const char *s : { "25326001", "3825123056546413051" }) {
+        EXPECT_FALSE(is_probable_prime(big_integer(s)));
+        EXPECT_FALSE(is_probable_prime(big_integer(s), 0, primality_test::bpsw));
+    }
+    //a square has no D for the Lucas test
+    EXPECT_FALSE(is_probable_prime(big_integer(4294967291u) * 4294967291u, 0, primality_test::bpsw));
+}
+
+TEST(correctness, next_prime)
+{
+    EXPECT_EQ(next_prime(-5), 2);
+    EXPECT_EQ(next_prime(2), 3);
+    EXPECT_EQ(next_prime(7), 11);
+    EXPECT_EQ(next_prime(2039), 2053);
+    EXPECT_EQ(next_prime(big_integer("100000000000000000000")), big_integer("100000000000000000039"));
+    EXPECT_EQ(next_prime((big_integer(1) << 127) - 2, 5, primality_test::bpsw), (big_integer(1) << 127) - 1);
+
+    big_integer p = big_integer("1000000000000");
+    for (int i = 0; i < 100; ++i) {
+        big_integer q = next_prime(p);
+        for (big_integer x = p + 1; x < q; x += 1)
+            EXPECT_FALSE(is_probable_prime(x));
+        EXPECT_TRUE(is_probable_prime(q));
+        p = q;
+    }
+}
+
+TEST(correctness, thread_pool)
+{
+    thread_pool pool(4);
+    EXPECT_EQ(pool.threads(), 4u);
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallel_for(hits.size(), [&](size_t i) {
+        ++hits[i];
+        pool.parallel_for(3, [&](size_t) { ++hits[i]; });
+    });
+    for (const std::atomic<int> &h : hits)
+        EXPECT_EQ(h.load(), 4);
+    thread_pool single(1);
+    int sum = 0;
+    single.parallel_for(10, [&](size_t i) { sum += (int)i; });
+    EXPECT_EQ(sum, 45);
+}
+
+TEST(correctness, mul_parallel)
+{
+    thread_pool pool(4, 16);
+    for (int i = 0; i < 20; ++i) {
+        big_integer a = random_big_integer(rand() % 300 + 1), b = random_big_integer(rand() % 300 + 1);
+        EXPECT_EQ(mul(a, b, pool), a * b);
+    }
+    big_integer a = random_big_integer(2000), b = random_big_integer(1500);
+    big_integer expected = a * b;
+    EXPECT_EQ(mul(a, b, pool), expected);
+    set_default_thread_pool(&pool);
+    EXPECT_EQ(a * b, expected);
+    EXPECT_EQ(b * a, expected);
+    set_default_thread_pool(nullptr);
+}
+
+TEST(correctness, parallel_conversion)
+{
+    thread_pool pool(4, 8);
+    for (int i = 0; i < 10; ++i) {
+        big_integer a = random_big_integer(rand() % 3000 + 1);
+        std::string s = to_string(a, 10);
+        EXPECT_EQ(to_string(a, 10, pool), s);
+        EXPECT_EQ(from_string(s.data(), s.data() + s.size(), 10, pool), a);
+    }
+    //long runs of zeros inside and right below a power of the radix
+    big_integer p = pow(big_integer(10), 40000);
+    for (big_integer a : { p, p - 1, p + 1, p * p + 7, (p - 1) * p }) {
+        std::string s = to_string(a, 10);
+        EXPECT_EQ(to_string(a, 10, pool), s);
+        EXPECT_EQ(from_string(s.data(), s.data() + s.size(), 10, pool), a);
+    }
+    big_integer a = random_big_integer(5000);
+    std::string s = to_string(a, 10);
+    set_default_thread_pool(&pool);
+    EXPECT_EQ(to_string(a, 10), s);
+    EXPECT_EQ(big_integer(s), a);
+    set_default_thread_pool(nullptr);
+}
+
+TEST(correctness, batch)
+{
+    const size_t n = 500;
+    std::vector<big_integer> a(n), b(n), out(n, big_integer(12345));
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = i % 7 ? random_big_integer(rand() % 40 + 1) : big_integer(0);
+        b[i] = random_big_integer(i % 50 ? rand() % 10 + 1 : 200);
+    }
+    big_integer m = random_big_integer(6);
+    thread_pool pool(4);
+    batch_mul(a.data(), b.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_EQ(out[i], a[i] * b[i]);
+    batch_mul(a.data(), b.data(), out.data(), n, pool);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_EQ(out[i], a[i] * b[i]);
+    batch_mulmod(a.data(), b.data(), m, out.data(), n, pool);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_EQ(out[i], a[i] * b[i] % m);
+    batch_mulmod(a.data(), b.data(), big_integer(-7), out.data(), n);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_EQ(out[i], a[i] * b[i] % -7);
+    batch_mul(a.data(), b.data(), out.data(), 0, pool);
+}
+
+TEST(correctness, work_stealing)
+{
+    thread_pool pool(4, 4);
+    //nested jobs at every level, each waiting for the ones it forked
+    std::function<int(int)> fib = [&](int n) {
+        if (n < 2)
+            return n;
+        int a = 0, b = 0;
+        pool.parallel_invoke([&] { a = fib(n - 1); }, [&] { b = fib(n - 2); });
+        return a + b;
+    };
+    EXPECT_EQ(fib(18), 2584);
+
+    std::vector<big_integer> x;
+    for (int i = 0; i < 300; ++i)
+        x.push_back(random_big_integer(rand() % 20 + 1));
+    std::vector<big_integer> y = x;
+    big_integer expected = big_integer_detail::product_tree(y, nullptr);
+    y = x;
+    EXPECT_EQ(big_integer_detail::product_tree(y, &pool), expected);
+
+    EXPECT_EQ(thread_count(), 1u);
+    set_thread_count(3, 8);
+    EXPECT_EQ(thread_count(), 3u);
+    EXPECT_EQ(product(x.begin(), x.end()), expected);
+    EXPECT_EQ(factorial(3000), factorial(2999) * 3000);
+    set_thread_count(1);
+    EXPECT_EQ(default_thread_pool(), nullptr);
+}
+
+TEST(correctness, bitwise_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1), b = random_big_integer(rand() % 80 + 1);
+        big_integer x = a & b, y = a | b, z = a ^ b;
+        EXPECT_EQ(x + y, a + b);
+        EXPECT_EQ(z, y - x);
+        EXPECT_EQ(~a, -a - 1);
+        EXPECT_EQ(andnot(a, b), a & ~b);
+        EXPECT_EQ(andnot(a, b) | x, a);
+        EXPECT_EQ(z ^ b, a);
+    }
+}
+
+TEST(correctness, shift_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1);
+        int k = rand() % 1200;
+        big_integer p = big_integer(1) << k, r = a >> k;
+        EXPECT_EQ(a << k, a * p);
+        EXPECT_EQ((a << k) >> k, a);
+        EXPECT_TRUE(r * p <= a && a < (r + 1) * p); //rounds towards minus infinity
+        big_integer b = a;
+        b <<= k;
+        b >>= k + 32;
+        EXPECT_EQ(b, a >> 32);
+        EXPECT_EQ(a << -k, r);
+    }
+    EXPECT_EQ(big_integer(-5) >> 1000, -1);
+    EXPECT_EQ(big_integer(5) >> 1000, 0);
+}
+
+TEST(correctness, compare_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1), c = a;
+        big_integer b = a ^ (big_integer(1) << (rand() % 2600)); //differs from a in a single bit, anywhere
+        big_integer d = random_big_integer(rand() % 80 + 1);
+        EXPECT_TRUE(a == c && !(a != c) && !(a < c) && a <= c);
+        EXPECT_TRUE(a != b && !(a == b));
+        EXPECT_EQ(a < b, a - b < 0);
+        EXPECT_EQ(b < a, b - a < 0);
+        EXPECT_EQ(a < d, a - d < 0);
+        EXPECT_EQ(a == d, a - d == 0);
+        EXPECT_EQ((a - b) + b, c); //normalize has to drop the cancelled high limbs
+        EXPECT_EQ(-a + a, 0);
+    }
+}
+
+TEST(correctness, three_way_compare)
+{
+    std::vector<big_integer> v;
+    for (int i = 0; i < 200; ++i)
+        v.push_back(random_big_integer(rand() % 6 + 1) >> (rand() % 150));
+    for (int x : {0, 1, -1, INT32_MAX, INT32_MIN})
+        v.push_back(x);
+    v.push_back(big_integer(UINT32_MAX));
+    v.push_back(big_integer((uint32_t)1 << 31));
+    std::sort(v.begin(), v.end());
+    for (size_t i = 0; i + 1 < v.size(); ++i) {
+        EXPECT_LE(v[i], v[i + 1]);
+        EXPECT_EQ(compare(v[i], v[i + 1]), v[i] == v[i + 1] ? 0 : -1);
+        EXPECT_EQ(compare(v[i + 1], v[i]), v[i] == v[i + 1] ? 0 : 1);
+        EXPECT_EQ(compare(big_integer_view(v[i]), big_integer_view(v[i + 1])), compare(v[i], v[i + 1]));
+    }
+    for (const big_integer &a : v)
+        for (uint32_t w : {0u, 1u, 5u, (uint32_t)INT32_MAX, (uint32_t)1 << 31, UINT32_MAX - 1, UINT32_MAX}) {
+            EXPECT_EQ(compare(a, w), compare(a, big_integer(w)));
+            EXPECT_EQ(compare(a, (int)w), compare(a, big_integer((int)w)));
+            EXPECT_EQ(a < w, a < big_integer(w));
+            EXPECT_EQ(w <= a, big_integer(w) <= a);
+            EXPECT_EQ((int)w == a, big_integer((int)w) == a);
+        }
+}
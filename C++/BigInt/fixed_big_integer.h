@@ -0,0 +1,454 @@
+#pragma once
+
+#include "big_integer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+//N-bit two's complement integer with wraparound semantics, like the built in signed types but wider.
+//Everything lives on the stack, every loop runs a compile-time number of times and all of the arithmetic is constexpr.
+template <size_t N>
+class fixed_big_integer
+{
+    static_assert(N > 0 && N % 32 == 0, "fixed_big_integer width must be a positive multiple of 32 bits");
+
+public:
+    static constexpr size_t LIMBS = N / 32;
+
+    constexpr fixed_big_integer();
+    constexpr fixed_big_integer(int b);
+    constexpr fixed_big_integer(uint32_t b);
+    explicit fixed_big_integer(const big_integer &b); //keeps the lowest N bits
+    explicit fixed_big_integer(std::string const &s);
+
+    explicit operator big_integer() const; //always exact
+
+    constexpr fixed_big_integer& operator+=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator-=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator*=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator/=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator%=(const fixed_big_integer &rhs);
+
+    constexpr fixed_big_integer& operator&=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator|=(const fixed_big_integer &rhs);
+    constexpr fixed_big_integer& operator^=(const fixed_big_integer &rhs);
+
+    constexpr fixed_big_integer& operator<<=(int rhs);
+    constexpr fixed_big_integer& operator>>=(int rhs);
+
+    constexpr fixed_big_integer operator+() const;
+    constexpr fixed_big_integer operator-() const;
+    constexpr fixed_big_integer operator~() const;
+
+    constexpr fixed_big_integer& operator++();
+    constexpr fixed_big_integer operator++(int);
+
+    constexpr fixed_big_integer& operator--();
+    constexpr fixed_big_integer operator--(int);
+
+    constexpr bool negative() const;
+    constexpr uint32_t limb(size_t i) const;
+    constexpr void set_limb(size_t i, uint32_t x);
+
+    //hidden friends, so that mixed expressions like a + 1 or a == 0 find them through the implicit conversions
+    friend constexpr fixed_big_integer operator + (fixed_big_integer a, const fixed_big_integer &b) {
+        return a += b;
+    }
+    friend constexpr fixed_big_integer operator - (fixed_big_integer a, const fixed_big_integer &b) {
+        return a -= b;
+    }
+    friend constexpr fixed_big_integer operator * (fixed_big_integer a, const fixed_big_integer &b) {
+        return a *= b;
+    }
+    friend constexpr fixed_big_integer operator / (fixed_big_integer a, const fixed_big_integer &b) {
+        return a /= b;
+    }
+    friend constexpr fixed_big_integer operator % (fixed_big_integer a, const fixed_big_integer &b) {
+        return a %= b;
+    }
+    friend constexpr fixed_big_integer operator & (fixed_big_integer a, const fixed_big_integer &b) {
+        return a &= b;
+    }
+    friend constexpr fixed_big_integer operator | (fixed_big_integer a, const fixed_big_integer &b) {
+        return a |= b;
+    }
+    friend constexpr fixed_big_integer operator ^ (fixed_big_integer a, const fixed_big_integer &b) {
+        return a ^= b;
+    }
+    friend constexpr fixed_big_integer operator << (fixed_big_integer a, int b) {
+        return a <<= b;
+    }
+    friend constexpr fixed_big_integer operator >> (fixed_big_integer a, int b) {
+        return a >>= b;
+    }
+
+    friend constexpr bool operator == (const fixed_big_integer &a, const fixed_big_integer &b) {
+        for (size_t i = 0; i < LIMBS; ++i)
+            if (a.data[i] != b.data[i])
+                return false;
+        return true;
+    }
+    friend constexpr bool operator != (const fixed_big_integer &a, const fixed_big_integer &b) {
+        return !(a == b);
+    }
+    friend constexpr bool operator < (const fixed_big_integer &a, const fixed_big_integer &b) {
+        if (a.negative() != b.negative())
+            return a.negative();
+        for (size_t i = LIMBS; i--; )
+            if (a.data[i] != b.data[i])
+                return a.data[i] < b.data[i];
+        return false;
+    }
+    friend constexpr bool operator > (const fixed_big_integer &a, const fixed_big_integer &b) {
+        return b < a;
+    }
+    friend constexpr bool operator <= (const fixed_big_integer &a, const fixed_big_integer &b) {
+        return !(b < a);
+    }
+    friend constexpr bool operator >= (const fixed_big_integer &a, const fixed_big_integer &b) {
+        return !(a < b);
+    }
+
+    friend std::string to_string(fixed_big_integer a) {
+        bool neg = a.negative();
+        if (neg)
+            a = -a;
+        std::string s;
+        do {
+            uint32_t r = divMod(a, 1000000000);
+            bool last = a == 0;
+            for (int i = 0; i < 9 && (!last || r != 0 || i == 0); ++i) {
+                s.push_back('0' + r % 10);
+                r /= 10;
+            }
+        } while (a != 0);
+        if (neg)
+            s.push_back('-');
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+
+private:
+    uint32_t data[LIMBS];
+    static constexpr uint32_t filler(uint32_t x);
+    static constexpr void divMod(fixed_big_integer &a, const fixed_big_integer &b, fixed_big_integer &q);
+    static constexpr uint32_t divMod(fixed_big_integer &a, uint32_t b);
+};
+
+template <size_t N>
+constexpr size_t fixed_big_integer<N>::LIMBS;
+
+template <size_t N>
+constexpr uint32_t fixed_big_integer<N>::filler(uint32_t x) {
+    return x >> 31 ? UINT32_MAX : 0;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N>::fixed_big_integer() :
+    data{}
+{
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N>::fixed_big_integer(int b) :
+    data{}
+{
+    data[0] = (uint32_t)b;
+    for (size_t i = 1; i < LIMBS; ++i)
+        data[i] = filler(data[0]);
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N>::fixed_big_integer(uint32_t b) :
+    data{}
+{
+    data[0] = b;
+}
+
+template <size_t N>
+fixed_big_integer<N>::fixed_big_integer(const big_integer &b) :
+    data{}
+{
+    size_t n = std::min(b.size, LIMBS);
+    std::copy(b.data, b.data + n, data);
+    std::fill(data + n, data + LIMBS, filler(b.data[b.size - 1]));
+}
+
+template <size_t N>
+fixed_big_integer<N>::fixed_big_integer(const std::string &s) :
+    data{}
+{
+    bool neg = s[0] == '-';
+    for (size_t i = neg; i < s.size(); ++i) {
+        *this *= 10;
+        *this += s[i] - '0';
+    }
+    if (neg)
+        *this = -*this;
+}
+
+template <size_t N>
+fixed_big_integer<N>::operator big_integer() const {
+    big_integer r;
+    r.resize(LIMBS);
+    std::copy(data, data + LIMBS, r.data);
+    r.normalize();
+    return r;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator += (const fixed_big_integer &b) {
+    uint32_t carry = 0;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint64_t sum = (uint64_t)data[i] + b.data[i] + carry;
+        data[i] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator -= (const fixed_big_integer &b) {
+    uint32_t carry = 0;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint64_t diff = (uint64_t)data[i] - b.data[i] - carry;
+        data[i] = (uint32_t)diff;
+        carry = diff >> 63;
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator *= (const fixed_big_integer &b) {
+    //two's complement product modulo 2^N is the same as the unsigned one, only the lower triangle is needed
+    fixed_big_integer r;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint32_t carry = 0;
+        for (size_t j = 0; i + j < LIMBS; ++j) {
+            uint64_t res = (uint64_t)data[i] * b.data[j] + carry + r.data[i + j];
+            r.data[i + j] = (uint32_t)res;
+            carry = res >> 32;
+        }
+    }
+    return *this = r;
+}
+
+template <size_t N>
+constexpr uint32_t fixed_big_integer<N>::divMod(fixed_big_integer &a, uint32_t b) { //a is unsigned here, returns remainder
+    uint32_t carry = 0;
+    for (size_t i = LIMBS; i--; ) {
+        uint64_t cur = ((uint64_t)carry << 32) | a.data[i];
+        a.data[i] = (uint32_t)(cur / b);
+        carry = (uint32_t)(cur % b);
+    }
+    return carry;
+}
+
+template <size_t N>
+constexpr void fixed_big_integer<N>::divMod(fixed_big_integer &a, const fixed_big_integer &b, fixed_big_integer &q) {
+    //unsigned Knuth division, a becomes the remainder
+    q = fixed_big_integer();
+    size_t n = LIMBS;
+    while (n > 0 && b.data[n - 1] == 0)
+        --n;
+    if (n <= 1) {
+        q = a;
+        a = fixed_big_integer(divMod(q, b.data[0]));
+        return;
+    }
+    size_t m = LIMBS;
+    while (m > 0 && a.data[m - 1] == 0)
+        --m;
+    if (m < n)
+        return;
+    int shift = 0;
+    while (!(b.data[n - 1] << shift >> 31))
+        ++shift;
+    uint32_t u[LIMBS + 1] = {};
+    uint32_t v[LIMBS] = {};
+    for (size_t i = 0; i < n; ++i)
+        v[i] = b.data[i] << shift | (shift && i ? b.data[i - 1] >> (32 - shift) : 0);
+    for (size_t i = 0; i <= m; ++i) {
+        uint32_t lo = i < m ? a.data[i] << shift : 0;
+        uint32_t hi = shift && i ? a.data[i - 1] >> (32 - shift) : 0;
+        u[i] = lo | hi;
+    }
+    for (size_t j = m - n + 1; j--; ) {
+        uint64_t num = ((uint64_t)u[j + n] << 32) | u[j + n - 1];
+        uint64_t qhat = num / v[n - 1];
+        uint64_t rhat = num % v[n - 1];
+        while (qhat >> 32 || qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >> 32)
+                break;
+        }
+        uint64_t borrow = 0, carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t p = qhat * v[i] + carry;
+            carry = p >> 32;
+            uint64_t diff = (uint64_t)u[i + j] - (uint32_t)p - borrow;
+            u[i + j] = (uint32_t)diff;
+            borrow = diff >> 63;
+        }
+        uint64_t diff = (uint64_t)u[j + n] - carry - borrow;
+        u[j + n] = (uint32_t)diff;
+        if (diff >> 63) { //qhat was still one too big
+            --qhat;
+            uint32_t c = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t sum = (uint64_t)u[i + j] + v[i] + c;
+                u[i + j] = (uint32_t)sum;
+                c = sum >> 32;
+            }
+            u[j + n] += c;
+        }
+        q.data[j] = (uint32_t)qhat;
+    }
+    for (size_t i = 0; i < LIMBS; ++i)
+        a.data[i] = i < n ? u[i] >> shift | (shift ? u[i + 1] << (32 - shift) : 0) : 0;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator /= (const fixed_big_integer &b) {
+    bool neg = negative() != b.negative();
+    fixed_big_integer r = negative() ? -*this : *this;
+    fixed_big_integer q;
+    divMod(r, b.negative() ? -b : b, q);
+    return *this = neg ? -q : q;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator %= (const fixed_big_integer &b) {
+    bool neg = negative();
+    fixed_big_integer r = neg ? -*this : *this;
+    fixed_big_integer q;
+    divMod(r, b.negative() ? -b : b, q);
+    return *this = neg ? -r : r;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator &= (const fixed_big_integer &b) {
+    for (size_t i = 0; i < LIMBS; ++i)
+        data[i] &= b.data[i];
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator |= (const fixed_big_integer &b) {
+    for (size_t i = 0; i < LIMBS; ++i)
+        data[i] |= b.data[i];
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator ^= (const fixed_big_integer &b) {
+    for (size_t i = 0; i < LIMBS; ++i)
+        data[i] ^= b.data[i];
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator <<= (int b) {
+    if (b < 0)
+        return *this >>= -b;
+    size_t bc = b >> 5, br = b & 31;
+    for (size_t i = LIMBS; i--; ) {
+        uint32_t hi = i >= bc ? data[i - bc] : 0;
+        uint32_t lo = i >= bc + 1 ? data[i - bc - 1] : 0;
+        data[i] = br ? hi << br | lo >> (32 - br) : hi;
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator >>= (int b) {
+    if (b < 0)
+        return *this <<= -b;
+    uint32_t as = filler(data[LIMBS - 1]);
+    size_t bc = b >> 5, br = b & 31;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        uint32_t lo = i + bc < LIMBS ? data[i + bc] : as;
+        uint32_t hi = i + bc + 1 < LIMBS ? data[i + bc + 1] : as;
+        data[i] = br ? lo >> br | hi << (32 - br) : lo;
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> fixed_big_integer<N>::operator + () const {
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> fixed_big_integer<N>::operator - () const {
+    fixed_big_integer b = ~*this;
+    return ++b;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> fixed_big_integer<N>::operator ~ () const {
+    fixed_big_integer r;
+    for (size_t i = 0; i < LIMBS; ++i)
+        r.data[i] = ~data[i];
+    return r;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator ++ () {
+    for (size_t i = 0; i < LIMBS && ++data[i] == 0; ++i) {
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> &fixed_big_integer<N>::operator -- () {
+    for (size_t i = 0; i < LIMBS && data[i]-- == 0; ++i) {
+    }
+    return *this;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> fixed_big_integer<N>::operator ++ (int) {
+    fixed_big_integer a = *this;
+    ++*this;
+    return a;
+}
+
+template <size_t N>
+constexpr fixed_big_integer<N> fixed_big_integer<N>::operator -- (int) {
+    fixed_big_integer a = *this;
+    --*this;
+    return a;
+}
+
+template <size_t N>
+constexpr bool fixed_big_integer<N>::negative() const {
+    return data[LIMBS - 1] >> 31;
+}
+
+template <size_t N>
+constexpr uint32_t fixed_big_integer<N>::limb(size_t i) const {
+    return data[i];
+}
+
+template <size_t N>
+constexpr void fixed_big_integer<N>::set_limb(size_t i, uint32_t x) {
+    data[i] = x;
+}
+
+template <size_t N>
+std::istream &operator >> (std::istream &in, fixed_big_integer<N> &a) {
+    std::string s;
+    in >> s;
+    a = fixed_big_integer<N>(s);
+    return in;
+}
+
+template <size_t N>
+std::ostream &operator << (std::ostream &out, const fixed_big_integer<N> &a) {
+    return out << to_string(a);
+}
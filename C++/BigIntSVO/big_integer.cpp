@@ -1,11 +1,20 @@
 #include "big_integer.h"
 #include <algorithm>
 #include <climits>
+#include <cstring>
 #include <vector>
 #include <functional>
 #include <cassert>
 #include <iostream>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIGINT_X86_DISPATCH
+#include <immintrin.h>
+#define BIGINT_AVX2 __attribute__((target("avx2")))
+#define BIGINT_AVX512 __attribute__((target("avx512f")))
+#define BIGINT_VBMI2 __attribute__((target("avx512f,avx512vbmi2")))
+#endif
+
 static const uint32_t BASE = UINT32_MAX; //not really base but actually BASE - 1
 
 static uint32_t filler(uint32_t x) { //the thing that we are using if we're filling the number in two complement form
@@ -21,6 +30,307 @@ static int maxbit(uint32_t n) { //Pre: n != 0
 	return temp;
 }
 
+//The bitwise loops are written once against an operation with a word, an AVX2 and an AVX-512 version of itself
+//and compiled for every instruction set; which one runs is decided by what the processor reports at startup.
+
+enum simd_level
+{
+	SIMD_NONE, //whatever the compiler makes of the plain loop, SSE2 on x86-64
+	SIMD_AVX2,
+	SIMD_AVX512,
+	SIMD_VBMI2 //AVX-512 plus the funnel shifts, which only the shift kernels look at
+};
+
+static simd_level detect_simd() {
+#ifdef BIGINT_X86_DISPATCH
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vbmi2"))
+		return SIMD_VBMI2;
+	if (__builtin_cpu_supports("avx512f"))
+		return SIMD_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return SIMD_AVX2;
+#endif
+	return SIMD_NONE;
+}
+
+//zero (SIMD_NONE) until the initializer has run, so early callers just get the plain loops
+static const simd_level SIMD = detect_simd();
+
+//shorter spans aren't worth leaving the plain loop for
+static const size_t SIMD_MIN_LIMBS = 16;
+
+struct and_op
+{
+	static uint32_t word(uint32_t x, uint32_t y) { return x & y; }
+#ifdef BIGINT_X86_DISPATCH
+	BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+	BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_and_si512(x, y); }
+#endif
+};
+
+struct or_op
+{
+	static uint32_t word(uint32_t x, uint32_t y) { return x | y; }
+#ifdef BIGINT_X86_DISPATCH
+	BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+	BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_or_si512(x, y); }
+#endif
+};
+
+struct xor_op
+{
+	static uint32_t word(uint32_t x, uint32_t y) { return x ^ y; }
+#ifdef BIGINT_X86_DISPATCH
+	BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+	BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+#endif
+};
+
+struct andnot_op
+{
+	static uint32_t word(uint32_t x, uint32_t y) { return x & ~y; }
+#ifdef BIGINT_X86_DISPATCH
+	BIGINT_AVX2 static __m256i avx2(__m256i x, __m256i y) { return _mm256_andnot_si256(y, x); }
+	//the unmasked form passes an undefined vector through, which GCC takes for a use of an uninitialized one
+	BIGINT_AVX512 static __m512i avx512(__m512i x, __m512i y) { return _mm512_maskz_andnot_epi32(0xffff, y, x); }
+#endif
+};
+
+//r = a op b limb by limb, b is either a span (step 1) or a single word broadcast over all of a (step 0); r may be a or b
+template <class Op>
+static void bitwise_plain(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	for (size_t i = 0; i < n; ++i)
+		r[i] = Op::word(a[i], b[i * step]);
+}
+
+#ifdef BIGINT_X86_DISPATCH
+template <class Op>
+BIGINT_AVX2 static void bitwise_avx2(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	const __m256i fill = _mm256_set1_epi32((int)b[0]);
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i y = step ? _mm256_loadu_si256((const __m256i *)(b + i)) : fill;
+		_mm256_storeu_si256((__m256i *)(r + i), Op::avx2(x, y));
+	}
+	bitwise_plain<Op>(r + i, a + i, b + i * step, step, n - i);
+}
+
+template <class Op>
+BIGINT_AVX512 static void bitwise_avx512(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	const __m512i fill = _mm512_set1_epi32((int)b[0]);
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + i));
+		__m512i y = step ? _mm512_loadu_si512((const void *)(b + i)) : fill;
+		_mm512_storeu_si512((void *)(r + i), Op::avx512(x, y));
+	}
+	bitwise_plain<Op>(r + i, a + i, b + i * step, step, n - i);
+}
+#endif
+
+template <class Op>
+static void bitwise(uint32_t *r, const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+#ifdef BIGINT_X86_DISPATCH
+	if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+		return bitwise_avx512<Op>(r, a, b, step, n);
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+		return bitwise_avx2<Op>(r, a, b, step, n);
+#endif
+	bitwise_plain<Op>(r, a, b, step, n);
+}
+
+static void not_n(uint32_t *r, const uint32_t *a, size_t n) {
+	const uint32_t ones = BASE;
+	bitwise<xor_op>(r, a, &ones, 0, n);
+}
+
+//one past the highest i < n with a[i] != b[i * step], 0 if there is none; step 0 compares against a single word.
+//The vector versions check 8 or 16 limbs per compare from the top and take the position from the mask
+static size_t mismatch_plain(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	while (n > 0 && a[n - 1] == b[(n - 1) * step])
+		--n;
+	return n;
+}
+
+#ifdef BIGINT_X86_DISPATCH
+BIGINT_AVX2 static size_t mismatch_avx2(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	const __m256i fill = _mm256_set1_epi32((int)b[0]);
+	for (; n >= 8; n -= 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + n - 8));
+		__m256i y = step ? _mm256_loadu_si256((const __m256i *)(b + n - 8)) : fill;
+		unsigned equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y)));
+		if (equal != 0xff)
+			return n - 8 + maxbit(~equal & 0xff) + 1;
+	}
+	return mismatch_plain(a, b, step, n);
+}
+
+BIGINT_AVX512 static size_t mismatch_avx512(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+	const __m512i fill = _mm512_set1_epi32((int)b[0]);
+	for (; n >= 16; n -= 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + n - 16));
+		__m512i y = step ? _mm512_loadu_si512((const void *)(b + n - 16)) : fill;
+		__mmask16 differ = _mm512_cmpneq_epi32_mask(x, y);
+		if (differ)
+			return n - 16 + maxbit(differ) + 1;
+	}
+	return mismatch_plain(a, b, step, n);
+}
+#endif
+
+static size_t mismatch(const uint32_t *a, const uint32_t *b, size_t step, size_t n) {
+#ifdef BIGINT_X86_DISPATCH
+	if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+		return mismatch_avx512(a, b, step, n);
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+		return mismatch_avx2(a, b, step, n);
+#endif
+	return mismatch_plain(a, b, step, n);
+}
+
+static size_t strip_fill(const uint32_t *a, size_t n, uint32_t fill) { //length without the leading limbs equal to fill
+	return mismatch(a, &fill, 0, n);
+}
+
+static size_t diff_length(const uint32_t *a, const uint32_t *b, size_t n) { //one past the highest limb where they differ
+	return mismatch(a, b, 1, n);
+}
+
+//r = a << k for 0 < k < 32 in a single pass, returns the bits shifted out; r may be a or anywhere above it.
+//The loop goes from the top down, so every limb is read before anything lands on it
+static uint32_t lshift_plain(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = n ? a[n - 1] >> (32 - k) : 0;
+	for (size_t i = n; i-- > 1; )
+		r[i] = a[i] << k | a[i - 1] >> (32 - k);
+	if (n)
+		r[0] = a[0] << k;
+	return out;
+}
+
+//r = a >> k for 0 < k < 32 in a single pass, returns the bits shifted out (in the high end of the limb); r may be a
+//or anywhere below it
+static uint32_t rshift_plain(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = n ? a[0] << (32 - k) : 0;
+	for (size_t i = 0; i + 1 < n; ++i)
+		r[i] = a[i] >> k | a[i + 1] << (32 - k);
+	if (n)
+		r[n - 1] = a[n - 1] >> k;
+	return out;
+}
+
+#ifdef BIGINT_X86_DISPATCH
+//without AVX-512 VBMI2 the funnel shift is two shifts and an or over a window one limb apart
+BIGINT_AVX2 static uint32_t lshift_avx2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[n - 1] >> (32 - k);
+	const __m128i up = _mm_cvtsi32_si128(k), down = _mm_cvtsi32_si128(32 - k);
+	size_t i = n;
+	for (; i >= 9; i -= 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + i - 8));
+		__m256i y = _mm256_loadu_si256((const __m256i *)(a + i - 9));
+		__m256i z = _mm256_or_si256(_mm256_sll_epi32(x, up), _mm256_srl_epi32(y, down));
+		_mm256_storeu_si256((__m256i *)(r + i - 8), z);
+	}
+	lshift_plain(r, a, i, k);
+	return out;
+}
+
+BIGINT_AVX2 static uint32_t rshift_avx2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[0] << (32 - k);
+	const __m128i down = _mm_cvtsi32_si128(k), up = _mm_cvtsi32_si128(32 - k);
+	size_t i = 0;
+	for (; i + 9 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i *)(a + i + 1));
+		__m256i z = _mm256_or_si256(_mm256_srl_epi32(x, down), _mm256_sll_epi32(y, up));
+		_mm256_storeu_si256((__m256i *)(r + i), z);
+	}
+	rshift_plain(r + i, a + i, n - i, k);
+	return out;
+}
+
+//the unmasked 512-bit shifts pass an undefined vector through, which -Wall reports as maybe uninitialized
+BIGINT_AVX512 static uint32_t lshift_avx512(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[n - 1] >> (32 - k);
+	const __m128i up = _mm_cvtsi32_si128(k), down = _mm_cvtsi32_si128(32 - k);
+	size_t i = n;
+	for (; i >= 17; i -= 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + i - 16));
+		__m512i y = _mm512_loadu_si512((const void *)(a + i - 17));
+		__m512i z = _mm512_or_si512(_mm512_maskz_sll_epi32(0xffff, x, up), _mm512_maskz_srl_epi32(0xffff, y, down));
+		_mm512_storeu_si512((void *)(r + i - 16), z);
+	}
+	lshift_plain(r, a, i, k);
+	return out;
+}
+
+BIGINT_AVX512 static uint32_t rshift_avx512(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[0] << (32 - k);
+	const __m128i down = _mm_cvtsi32_si128(k), up = _mm_cvtsi32_si128(32 - k);
+	size_t i = 0;
+	for (; i + 17 <= n; i += 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + i));
+		__m512i y = _mm512_loadu_si512((const void *)(a + i + 1));
+		__m512i z = _mm512_or_si512(_mm512_maskz_srl_epi32(0xffff, x, down), _mm512_maskz_sll_epi32(0xffff, y, up));
+		_mm512_storeu_si512((void *)(r + i), z);
+	}
+	rshift_plain(r + i, a + i, n - i, k);
+	return out;
+}
+
+//vpshldvd and vpshrdvd are the funnel shift in one instruction
+BIGINT_VBMI2 static uint32_t lshift_vbmi2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[n - 1] >> (32 - k);
+	const __m512i count = _mm512_set1_epi32(k);
+	size_t i = n;
+	for (; i >= 17; i -= 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + i - 16));
+		__m512i y = _mm512_loadu_si512((const void *)(a + i - 17));
+		_mm512_storeu_si512((void *)(r + i - 16), _mm512_shldv_epi32(x, y, count));
+	}
+	lshift_plain(r, a, i, k);
+	return out;
+}
+
+BIGINT_VBMI2 static uint32_t rshift_vbmi2(uint32_t *r, const uint32_t *a, size_t n, int k) {
+	const uint32_t out = a[0] << (32 - k);
+	const __m512i count = _mm512_set1_epi32(k);
+	size_t i = 0;
+	for (; i + 17 <= n; i += 16) {
+		__m512i x = _mm512_loadu_si512((const void *)(a + i));
+		__m512i y = _mm512_loadu_si512((const void *)(a + i + 1));
+		_mm512_storeu_si512((void *)(r + i), _mm512_shrdv_epi32(x, y, count));
+	}
+	rshift_plain(r + i, a + i, n - i, k);
+	return out;
+}
+#endif
+
+static uint32_t lshift(uint32_t *r, const uint32_t *a, size_t n, int k) {
+#ifdef BIGINT_X86_DISPATCH
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_VBMI2)
+		return lshift_vbmi2(r, a, n, k);
+	if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+		return lshift_avx512(r, a, n, k);
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+		return lshift_avx2(r, a, n, k);
+#endif
+	return lshift_plain(r, a, n, k);
+}
+
+static uint32_t rshift(uint32_t *r, const uint32_t *a, size_t n, int k) {
+#ifdef BIGINT_X86_DISPATCH
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_VBMI2)
+		return rshift_vbmi2(r, a, n, k);
+	if (n >= SIMD_MIN_LIMBS && SIMD >= SIMD_AVX512)
+		return rshift_avx512(r, a, n, k);
+	if (n >= SIMD_MIN_LIMBS && SIMD == SIMD_AVX2)
+		return rshift_avx2(r, a, n, k);
+#endif
+	return rshift_plain(r, a, n, k);
+}
+
 static uint32_t* dataAlloc(size_t s)
 {
 	size_t* data = (size_t*)new uint8_t[sizeof(size_t) + s * sizeof(uint32_t)];
@@ -59,15 +369,6 @@ static void dataUnRef(uint32_t * x)
 		delete[](uint8_t*)r;
 }
 
-uint32_t* big_integer::get_data() const
-{
-	return size > SMALLSIZE ? dataUnion.data : (uint32_t*)dataUnion.chunk;
-}
-
-big_integer::big_integer() :
-	big_integer(0) {
-}
-
 big_integer::big_integer(const big_integer &b) :
 	size(b.size), dataUnion(b.dataUnion)
 {
@@ -88,12 +389,6 @@ big_integer::big_integer(const std::string &s) :
 		*this = -*this;
 }
 
-big_integer::big_integer(int b) :
-	size(1)
-{
-	dataUnion.chunk[0] = b;
-}
-
 big_integer::big_integer(uint32_t b) {
 	dataUnion.chunk[0] = b;
 	if (b < (uint32_t)1 << 31) {
@@ -110,11 +405,6 @@ big_integer::~big_integer() {
 		dataUnRef(dataUnion.data);
 }
 
-void big_integer::swap(big_integer& b) {
-	std::swap(size, b.size);
-	std::swap(dataUnion, b.dataUnion);
-}
-
 big_integer & big_integer::operator = (big_integer const & b)
 {
 	if (size > SMALLSIZE)
@@ -126,33 +416,17 @@ big_integer & big_integer::operator = (big_integer const & b)
 	return *this;
 }
 
-big_integer &big_integer::operator += (const big_integer &b) {
-	return *this = *this + b;
-}
-big_integer &big_integer::operator -= (const big_integer &b) {
-	return *this = *this - b;
-}
-big_integer &big_integer::operator *= (const big_integer &b) {
-	return *this = *this * b;
-}
-
-big_integer &big_integer::operator /= (const big_integer &b) {
-	return *this = *this / b;
-}
-
-big_integer &big_integer::operator %= (const big_integer &b) {
-	return *this = *this % b;
-}
+//Above b's length b is all fill, i.e. all zeros or all ones, so the tail of a is either left alone, cleared, set
+//or inverted
 
 big_integer &big_integer::operator &= (const big_integer &b) {
 	dupe();
 	if (size < b.size)
 		resize(b.size);
-	for (size_t i = 0; i < b.size; ++i)
-		get_data()[i] &= b.get_data()[i];
-	const uint32_t fill = filler(b.get_data()[b.size - 1]);
-	for (size_t i = b.size; i < size; ++i)
-		get_data()[i] &= fill;
+	uint32_t *data = get_data();
+	bitwise<and_op>(data, data, b.get_data(), 1, b.size);
+	if (!b.negative())
+		std::fill(data + b.size, data + size, 0);
 	normalize();
 	return *this;
 }
@@ -161,11 +435,10 @@ big_integer &big_integer::operator |= (const big_integer &b) {
 	dupe();
 	if (size < b.size)
 		resize(b.size);
-	for (size_t i = 0; i < b.size; ++i)
-		get_data()[i] |= b.get_data()[i];
-	const uint32_t fill = filler(b.get_data()[b.size - 1]);
-	for (size_t i = b.size; i < size; ++i)
-		get_data()[i] |= fill;
+	uint32_t *data = get_data();
+	bitwise<or_op>(data, data, b.get_data(), 1, b.size);
+	if (b.negative())
+		std::fill(data + b.size, data + size, BASE);
 	normalize();
 	return *this;
 }
@@ -174,51 +447,85 @@ big_integer &big_integer::operator ^= (const big_integer &b) {
 	dupe();
 	if (size < b.size)
 		resize(b.size);
-	for (size_t i = 0; i < b.size; ++i)
-		get_data()[i] ^= b.get_data()[i];
-	uint32_t fill = filler(b.get_data()[b.size - 1]);
-	for (size_t i = b.size; i < size; ++i)
-		get_data()[i] ^= fill;
+	uint32_t *data = get_data();
+	bitwise<xor_op>(data, data, b.get_data(), 1, b.size);
+	if (b.negative())
+		not_n(data + b.size, data + b.size, size - b.size);
 	normalize();
 	return *this;
 }
 
+big_integer andnot(big_integer a, const big_integer &b) {
+	a.dupe();
+	if (a.size < b.size)
+		a.resize(b.size);
+	uint32_t *data = a.get_data();
+	bitwise<andnot_op>(data, data, b.get_data(), 1, b.size);
+	if (b.negative())
+		std::fill(data + b.size, data + a.size, 0);
+	a.normalize();
+	return a;
+}
+
+//Both shifts touch every limb once: whole limbs move with a plain copy, the bits within a limb go through the
+//funnel shift kernels, which write straight into where the limbs end up
+
+void big_integer::shift_left_from(const uint32_t *a, size_t n, int b) {
+	const size_t bc = b >> 5, nsize = n + bc + 1;
+	const int br = b & 31;
+	uint32_t *old = size > SMALLSIZE ? dataUnion.data : nullptr;
+	uint32_t *r = nsize > SMALLSIZE ? dataAlloc(nsize) : dataUnion.chunk; //the small buffer only when a is one limb
+	const uint32_t fill = filler(a[n - 1]);
+	std::fill(r, r + bc, 0);
+	if (br != 0)
+		r[nsize - 1] = lshift(r + bc, a, n, br) | fill << br;
+	else {
+		std::memmove(r + bc, a, n * sizeof(uint32_t));
+		r[nsize - 1] = fill;
+	}
+	if (old)
+		dataUnRef(old);
+	size = nsize;
+	if (size > SMALLSIZE) {
+		dataRef(r);
+		dataUnion.data = r;
+	}
+	normalize();
+}
+
 big_integer &big_integer::operator <<= (int b) {
-	dupe();
 	if (b < 0)
 		return *this >>= -b;
-	size_t bc = b >> 5, br = b & 31;
-	resize(size + bc + 1);
-	for (size_t i = size - 1; i != (size_t)-1; --i)
-		get_data()[i] = (i >= bc ? get_data()[i - bc] : 0);
-	if (br != 0)
-		for (size_t i = size - 1; i != (size_t)-1; --i) {
-			get_data()[i] <<= br;
-			if (i != 0)
-				get_data()[i] |= (get_data()[i - 1] >> (32 - br));
-		}
-	normalize();
+	shift_left_from(get_data(), size, b);
 	return *this;
 }
+
 big_integer &big_integer::operator >>= (int b) {
-	dupe();
 	if (b < 0)
 		return *this <<= -b;
-	uint32_t as = filler(get_data()[size - 1]);
-	size_t bc = b >> 5, br = b & 31;
-	for (size_t i = 0; i < size; ++i)
-		get_data()[i] = (i + bc < size ? get_data()[i + bc] : as);
-	if (br != 0)
-		for (size_t i = 0; i < size; ++i) {
-			get_data()[i] >>= br;
-			get_data()[i] |= (i + 1 == size ? as : get_data()[i + 1]) << (32 - br);
-		}
+	dupe();
+	uint32_t *data = get_data();
+	const uint32_t fill = filler(data[size - 1]);
+	const size_t bc = std::min((size_t)(b >> 5), size);
+	const int br = b & 31;
+	const size_t n = size - bc;
+	if (br != 0 && n != 0) {
+		rshift(data, data + bc, n, br);
+		data[n - 1] |= fill << (32 - br);
+	}
+	else
+		std::memmove(data, data + bc, n * sizeof(uint32_t));
+	std::fill(data + n, data + size, fill); //normalize drops it together with whatever was there already
 	normalize();
 	return *this;
 }
 
-big_integer big_integer::operator + () const {
-	return *this;
+big_integer operator << (const big_integer &a, int b) {
+	if (b < 0)
+		return a >> -b;
+	big_integer r;
+	r.shift_left_from(a.get_data(), a.size, b);
+	return r;
 }
 
 big_integer big_integer::operator - () const {
@@ -229,32 +536,12 @@ big_integer big_integer::operator - () const {
 big_integer big_integer::operator ~ () const {
 	big_integer r;
 	r.resize(size);
-	for (size_t i = 0; i < size; ++i)
-		r.get_data()[i] = ~(get_data()[i]);
+	not_n(r.get_data(), get_data(), size);
 	return r;
 }
 
-big_integer &big_integer::operator ++ () {
-	return *this += 1;
-}
-
-big_integer &big_integer::operator -- () {
-	return *this -= 1;
-}
-
-big_integer big_integer::operator ++ (int) {
-	big_integer a = *this;
-	++*this;
-	return a;
-}
-
-big_integer big_integer::operator -- (int) {
-	big_integer a = *this;
-	--*this;
-	return a;
-}
-
-big_integer operator + (big_integer a, const big_integer &b) {
+big_integer &big_integer::add_long(const big_integer &b) {
+	big_integer &a = *this;
 	a.dupe();
 	//std::cerr << a << " + " << b << "\n";
 	if (a.size < b.size)
@@ -284,7 +571,8 @@ big_integer operator + (big_integer a, const big_integer &b) {
 	return a;
 }
 
-big_integer operator - (big_integer a, const big_integer &b) {
+big_integer &big_integer::sub_long(const big_integer &b) {
+	big_integer &a = *this;
 	a.dupe();
 	if (a.size < b.size)
 		a.resize(b.size);
@@ -311,13 +599,13 @@ big_integer operator - (big_integer a, const big_integer &b) {
 }
 
 big_integer operator * (const big_integer &a, const big_integer &b) {
-	if (a < 0) {
-		if (b < 0)
+	if (a.negative()) {
+		if (b.negative())
 			return (-a) * (-b);
 		else
 			return -((-a) * b);
 	}
-	else if (b < 0)
+	else if (b.negative())
 		return -(a * (-b));
 	big_integer r;
 	r.resize(a.size + b.size);
@@ -378,7 +666,7 @@ std::pair <big_integer, big_integer> big_integer::divMod(const big_integer &b) {
 			q.get_data()[j] = static_cast<uint32_t>(temp);
 		}
 		*this -= q.get_data()[j] * (b << (j * 32));
-		while (*this < 0) {
+		while (negative()) {
 			--q.get_data()[j];
 			*this += (b << (j * 32));
 		}
@@ -389,93 +677,58 @@ std::pair <big_integer, big_integer> big_integer::divMod(const big_integer &b) {
 }
 
 big_integer operator / (big_integer a, const big_integer &b) {
-	if (a < 0)
-		if (b < 0)
+	if (a.negative())
+		if (b.negative())
 			return (-a) / (-b);
 		else
 			return -((-a) / b);
-	else if (b < 0)
+	else if (b.negative())
 		return -(a / (-b));
 	a.dupe();
 	return a.divMod(b).first;
 }
 
 big_integer operator % (big_integer a, const big_integer &b) {
-	if (a < 0)
-		if (b < 0)
+	if (a.negative())
+		if (b.negative())
 			return -(-a) % (-b);
 		else
 			return -((-a) % b);
-	else if (b < 0)
+	else if (b.negative())
 		return (a % (-b));
 	a.dupe();
 	return a.divMod(b).second;
 }
 
-big_integer operator & (big_integer a, const big_integer &b) {
-	return a &= b;
-}
-big_integer operator | (big_integer a, const big_integer &b) {
-	return a |= b;
-}
-big_integer operator ^ (big_integer a, const big_integer &b) {
-	return a ^= b;
-}
-
-big_integer operator << (big_integer a, int b) {
-	return a <<= b;
-}
-
-big_integer operator >> (big_integer a, int b) {
-	return a >>= b;
-}
-
-bool operator == (const big_integer &a, const big_integer &b) {
-	for (size_t i = 0; i < std::min(a.size, b.size); ++i)
-		if (a.get_data()[i] != b.get_data()[i])
-			return false;
-	uint32_t afill = filler(a.get_data()[a.size - 1]);
-	for (size_t i = a.size; i < b.size; ++i)
-		if (afill != b.get_data()[i])
-			return false;
-	uint32_t bfill = filler(b.get_data()[b.size - 1]);
-	for (size_t i = b.size; i < a.size; ++i)
-		if (bfill != a.get_data()[i])
-			return false;
-	return true;
-}
-
-bool operator != (const big_integer &a, const big_integer &b) {
-	return !(a == b);
+bool big_integer::equal_long(const big_integer &a, const big_integer &b) {
+	const uint32_t *ad = a.get_data(), *bd = b.get_data();
+	if (diff_length(ad, bd, std::min(a.size, b.size)) != 0)
+		return false;
+	if (a.size < b.size)
+		return strip_fill(bd + a.size, b.size - a.size, filler(ad[a.size - 1])) == 0;
+	return strip_fill(ad + b.size, a.size - b.size, filler(bd[b.size - 1])) == 0;
 }
 
-bool operator < (const big_integer &a, const big_integer &b) {
-	uint32_t afill = filler(a.get_data()[a.size - 1]);
-	uint32_t bfill = filler(b.get_data()[b.size - 1]);
+int big_integer::compare_long(const big_integer &a, const big_integer &b) {
+	const uint32_t *ad = a.get_data(), *bd = b.get_data();
+	uint32_t afill = filler(ad[a.size - 1]);
+	uint32_t bfill = filler(bd[b.size - 1]);
 	if (afill != bfill)
-		return afill > bfill;
-	for (size_t i = b.size; i-- > a.size;)
-		if (afill != b.get_data()[i])
-			return afill < b.get_data()[i];
-	for (size_t i = a.size; i-- > b.size;)
-		if (bfill != a.get_data()[i])
-			return a.get_data()[i] < bfill;
-	for (size_t i = std::min(a.size, b.size); i--; )
-		if (a.get_data()[i] != b.get_data()[i])
-			return a.get_data()[i] < b.get_data()[i];
-	return false;
-}
-
-bool operator > (const big_integer &a, const big_integer &b) {
-	return b < a;
-}
-
-bool operator <= (const big_integer &a, const big_integer &b) {
-	return !(b < a);
-}
-
-bool operator >= (const big_integer &a, const big_integer &b) {
-	return !(a < b);
+		return afill ? -1 : 1;
+	if (b.size > a.size) { //the part of b above a against the sign extension of a
+		size_t n = strip_fill(bd + a.size, b.size - a.size, afill);
+		if (n != 0)
+			return afill < bd[a.size + n - 1] ? -1 : 1;
+	}
+	if (a.size > b.size) {
+		size_t n = strip_fill(ad + b.size, a.size - b.size, bfill);
+		if (n != 0)
+			return ad[b.size + n - 1] < bfill ? -1 : 1;
+	}
+	size_t n = diff_length(ad, bd, std::min(a.size, b.size));
+	if (n == 0)
+		return 0;
+	return ad[n - 1] < bd[n - 1] ? -1 : 1;
 }
 
 std::string to_string(big_integer a) {
@@ -483,7 +736,7 @@ std::string to_string(big_integer a) {
 		return "0";
 	std::string s;
 	bool neg = false;
-	if (a < 0) {
+	if (a.negative()) {
 		neg = true;
 		a = -a;
 	}
@@ -522,8 +775,10 @@ void big_integer::resize(size_t nsize) {
 	}
 	else {
 		ndata = dataAlloc(nsize, std::nothrow);
-		if (ndata == nullptr)
+		if (ndata == nullptr) { //keep the longer buffer, but the size has to shrink: compare and == rely on it
+			size = nsize;
 			return;
+		}
 	}
 	if (data != ndata)
 		std::copy(data, data + std::min(size, nsize), ndata);
@@ -551,15 +806,12 @@ void big_integer::dupe() {
 }
 
 void big_integer::normalize() {
-	uint32_t fill = filler(get_data()[size - 1]);
-	for (size_t i = size; i--; )
-		if (get_data()[i] != fill || i == 0) {
-			if (filler(get_data()[i]) != fill) { //this shouldn't usually happen tho..., happens only if last block was eq to fill and last but one has wrong last bit
-				resize(i + 2);
-			}
-			else {
-				resize(i + 1);
-			}
-			return;
-		}
+	const uint32_t fill = filler(get_data()[size - 1]);
+	const size_t n = strip_fill(get_data(), size, fill);
+	if (n == 0)
+		resize(1);
+	else if (filler(get_data()[n - 1]) != fill) //this shouldn't usually happen tho..., happens only if last block was eq to fill and last but one has wrong last bit
+		resize(n + 1);
+	else
+		resize(n);
 }
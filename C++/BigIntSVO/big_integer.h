@@ -1,13 +1,21 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <utility>
+
+#if __cplusplus > 201703L && defined(__cpp_impl_three_way_comparison)
+#include <compare>
+#define BIGINT_THREE_WAY_COMPARISON
+#endif
 
 class big_integer
 {
 public:
 	big_integer();
 	big_integer(const big_integer &b);
+	big_integer(big_integer &&b) noexcept;
 	big_integer(int b);
 	big_integer(uint32_t b);
 	explicit big_integer(std::string const &s);
@@ -15,6 +23,7 @@ public:
 	~big_integer();
 
 	big_integer& operator=(const big_integer &other);
+	big_integer& operator=(big_integer &&other) noexcept;
 
 	big_integer& operator+=(const big_integer &rhs);
 	big_integer& operator-=(const big_integer &rhs);
@@ -45,6 +54,9 @@ public:
 	friend bool operator>(const big_integer &a, const big_integer &b);
 	friend bool operator<=(const big_integer &a, const big_integer &b);
 	friend bool operator>=(const big_integer &a, const big_integer &b);
+	friend int compare(const big_integer &a, const big_integer &b);
+	friend int compare(const big_integer &a, int b);
+	friend int compare(const big_integer &a, uint32_t b);
 
 	friend big_integer operator + (big_integer a, const big_integer &b);
 	friend big_integer operator - (big_integer a, const big_integer &b);
@@ -54,7 +66,8 @@ public:
 	friend big_integer operator & (big_integer a, const big_integer &b);
 	friend big_integer operator | (big_integer a, const big_integer &b);
 	friend big_integer operator ^ (big_integer a, const big_integer &b);
-	friend big_integer operator << (big_integer a, int b);
+	friend big_integer andnot(big_integer a, const big_integer &b);
+	friend big_integer operator << (const big_integer &a, int b);
 	friend big_integer operator >> (big_integer a, int b);
 
 	friend std::string to_string(big_integer a);
@@ -71,8 +84,15 @@ private:
 	} dataUnion;
 	uint32_t* get_data() const;
 	void dupe();
-	void resize(size_t nsize);
+	void resize(size_t nsize); //size is always nsize afterwards, even if a shrink couldn't get a smaller buffer
+	void shift_left_from(const uint32_t *a, size_t n, int b); //*this = a[0, n) << b for b >= 0, a may be get_data()
 	void normalize();
+	bool negative() const;
+	bool small() const;
+	big_integer& add_long(const big_integer &b);
+	big_integer& sub_long(const big_integer &b);
+	static bool equal_long(const big_integer &a, const big_integer &b);
+	static int compare_long(const big_integer &a, const big_integer &b);
 	std::pair <big_integer, big_integer> divMod(const big_integer &b);
 };
 
@@ -84,7 +104,8 @@ big_integer operator % (big_integer a, const big_integer &b);
 big_integer operator & (big_integer a, const big_integer &b);
 big_integer operator | (big_integer a, const big_integer &b);
 big_integer operator ^ (big_integer a, const big_integer &b);
-big_integer operator << (big_integer a, int b);
+big_integer andnot(big_integer a, const big_integer &b); //a & ~b without building ~b
+big_integer operator << (const big_integer &a, int b); //straight into a new buffer, a is never copied
 big_integer operator >> (big_integer a, int b);
 
 bool operator == (const big_integer &a, const big_integer &b);
@@ -94,6 +115,340 @@ bool operator > (const big_integer &a, const big_integer &b);
 bool operator <= (const big_integer &a, const big_integer &b);
 bool operator >= (const big_integer &a, const big_integer &b);
 
+//-1, 0 or 1 as a is less than, equal to or greater than b, in one scan from the top. Both are normalized, so with
+//the same sign the longer one is further from zero and that is settled without looking at the limbs
+int compare(const big_integer &a, const big_integer &b);
+
+//against a single word without making a big_integer out of it first
+int compare(const big_integer &a, int b);
+int compare(const big_integer &a, uint32_t b);
+bool operator == (const big_integer &a, int b);
+bool operator != (const big_integer &a, int b);
+bool operator < (const big_integer &a, int b);
+bool operator > (const big_integer &a, int b);
+bool operator <= (const big_integer &a, int b);
+bool operator >= (const big_integer &a, int b);
+bool operator == (int a, const big_integer &b);
+bool operator != (int a, const big_integer &b);
+bool operator < (int a, const big_integer &b);
+bool operator > (int a, const big_integer &b);
+bool operator <= (int a, const big_integer &b);
+bool operator >= (int a, const big_integer &b);
+bool operator == (const big_integer &a, uint32_t b);
+bool operator != (const big_integer &a, uint32_t b);
+bool operator < (const big_integer &a, uint32_t b);
+bool operator > (const big_integer &a, uint32_t b);
+bool operator <= (const big_integer &a, uint32_t b);
+bool operator >= (const big_integer &a, uint32_t b);
+bool operator == (uint32_t a, const big_integer &b);
+bool operator != (uint32_t a, const big_integer &b);
+bool operator < (uint32_t a, const big_integer &b);
+bool operator > (uint32_t a, const big_integer &b);
+bool operator <= (uint32_t a, const big_integer &b);
+bool operator >= (uint32_t a, const big_integer &b);
+
+#ifdef BIGINT_THREE_WAY_COMPARISON
+std::strong_ordering operator <=> (const big_integer &a, const big_integer &b);
+std::strong_ordering operator <=> (const big_integer &a, int b);
+std::strong_ordering operator <=> (const big_integer &a, uint32_t b);
+#endif
+
 std::string to_string(big_integer a);
 std::istream & operator >> (std::istream &in, big_integer &a);
-std::ostream & operator << (std::ostream & out, const big_integer & a);
\ No newline at end of file
+std::ostream & operator << (std::ostream & out, const big_integer & a);
+
+//everything below is small enough to be inlined into the caller, the heavy loops stay in big_integer.cpp
+
+inline uint32_t* big_integer::get_data() const
+{
+	return size > SMALLSIZE ? dataUnion.data : (uint32_t*)dataUnion.chunk;
+}
+
+inline big_integer::big_integer() :
+	big_integer(0) {
+}
+
+inline big_integer::big_integer(big_integer &&b) noexcept :
+	size(b.size), dataUnion(b.dataUnion)
+{
+	//leave b as a valid zero, that costs nothing thanks to the small buffer
+	b.size = 1;
+	b.dataUnion.chunk[0] = 0;
+}
+
+inline big_integer::big_integer(int b) :
+	size(1)
+{
+	dataUnion.chunk[0] = b;
+}
+
+inline void big_integer::swap(big_integer& b) {
+	std::swap(size, b.size);
+	std::swap(dataUnion, b.dataUnion);
+}
+
+inline big_integer &big_integer::operator = (big_integer &&b) noexcept {
+	swap(b);
+	return *this;
+}
+
+inline bool big_integer::negative() const {
+	return get_data()[size - 1] >> 31;
+}
+
+inline bool big_integer::small() const { //fits into one limb, i.e. into int32_t
+	return size == 1;
+}
+
+inline big_integer &big_integer::operator += (const big_integer &b) {
+	if (small() && b.small()) {
+		int64_t sum = (int64_t)(int32_t)dataUnion.chunk[0] + (int32_t)b.dataUnion.chunk[0];
+		if (sum == (int32_t)sum) {
+			dataUnion.chunk[0] = (uint32_t)sum;
+			return *this;
+		}
+	}
+	return add_long(b);
+}
+
+inline big_integer &big_integer::operator -= (const big_integer &b) {
+	if (small() && b.small()) {
+		int64_t diff = (int64_t)(int32_t)dataUnion.chunk[0] - (int32_t)b.dataUnion.chunk[0];
+		if (diff == (int32_t)diff) {
+			dataUnion.chunk[0] = (uint32_t)diff;
+			return *this;
+		}
+	}
+	return sub_long(b);
+}
+
+inline big_integer &big_integer::operator *= (const big_integer &b) {
+	return *this = *this * b;
+}
+
+inline big_integer &big_integer::operator /= (const big_integer &b) {
+	return *this = *this / b;
+}
+
+inline big_integer &big_integer::operator %= (const big_integer &b) {
+	return *this = *this % b;
+}
+
+inline big_integer big_integer::operator + () const {
+	return *this;
+}
+
+inline big_integer &big_integer::operator ++ () {
+	return *this += 1;
+}
+
+inline big_integer &big_integer::operator -- () {
+	return *this -= 1;
+}
+
+inline big_integer big_integer::operator ++ (int) {
+	big_integer a = *this;
+	++*this;
+	return a;
+}
+
+inline big_integer big_integer::operator -- (int) {
+	big_integer a = *this;
+	--*this;
+	return a;
+}
+
+inline big_integer operator + (big_integer a, const big_integer &b) {
+	a += b;
+	return a;
+}
+
+inline big_integer operator - (big_integer a, const big_integer &b) {
+	a -= b;
+	return a;
+}
+
+inline big_integer operator & (big_integer a, const big_integer &b) {
+	a &= b;
+	return a;
+}
+
+inline big_integer operator | (big_integer a, const big_integer &b) {
+	a |= b;
+	return a;
+}
+
+inline big_integer operator ^ (big_integer a, const big_integer &b) {
+	a ^= b;
+	return a;
+}
+
+inline big_integer operator >> (big_integer a, int b) {
+	a >>= b;
+	return a;
+}
+
+inline int compare(const big_integer &a, const big_integer &b) {
+	if (a.small() && b.small()) {
+		int32_t x = (int32_t)a.dataUnion.chunk[0], y = (int32_t)b.dataUnion.chunk[0];
+		return (x > y) - (x < y);
+	}
+	if (a.size != b.size && a.negative() == b.negative())
+		return (a.size < b.size) != a.negative() ? -1 : 1;
+	return big_integer::compare_long(a, b);
+}
+
+inline int compare(const big_integer &a, int b) {
+	if (!a.small()) //doesn't fit into int32_t, so the sign alone decides
+		return a.negative() ? -1 : 1;
+	int32_t x = (int32_t)a.dataUnion.chunk[0];
+	return (x > b) - (x < b);
+}
+
+inline int compare(const big_integer &a, uint32_t b) {
+	if (b >> 31 == 0)
+		return compare(a, (int)b);
+	if (a.negative() || a.small()) //anything in one limb is below 2^31
+		return -1;
+	if (a.size > 2 || a.dataUnion.chunk[1] != 0)
+		return 1;
+	return (a.dataUnion.chunk[0] > b) - (a.dataUnion.chunk[0] < b);
+}
+
+inline bool operator == (const big_integer &a, const big_integer &b) {
+	if (a.size != b.size)
+		return false;
+	if (a.small())
+		return a.dataUnion.chunk[0] == b.dataUnion.chunk[0];
+	return big_integer::equal_long(a, b);
+}
+
+inline bool operator != (const big_integer &a, const big_integer &b) {
+	return !(a == b);
+}
+
+inline bool operator < (const big_integer &a, const big_integer &b) {
+	return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, const big_integer &b) {
+	return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, const big_integer &b) {
+	return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, const big_integer &b) {
+	return compare(a, b) >= 0;
+}
+
+inline bool operator == (const big_integer &a, int b) {
+	return compare(a, b) == 0;
+}
+
+inline bool operator != (const big_integer &a, int b) {
+	return compare(a, b) != 0;
+}
+
+inline bool operator < (const big_integer &a, int b) {
+	return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, int b) {
+	return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, int b) {
+	return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, int b) {
+	return compare(a, b) >= 0;
+}
+
+inline bool operator == (int a, const big_integer &b) {
+	return compare(b, a) == 0;
+}
+
+inline bool operator != (int a, const big_integer &b) {
+	return compare(b, a) != 0;
+}
+
+inline bool operator < (int a, const big_integer &b) {
+	return compare(b, a) > 0;
+}
+
+inline bool operator > (int a, const big_integer &b) {
+	return compare(b, a) < 0;
+}
+
+inline bool operator <= (int a, const big_integer &b) {
+	return compare(b, a) >= 0;
+}
+
+inline bool operator >= (int a, const big_integer &b) {
+	return compare(b, a) <= 0;
+}
+
+inline bool operator == (const big_integer &a, uint32_t b) {
+	return compare(a, b) == 0;
+}
+
+inline bool operator != (const big_integer &a, uint32_t b) {
+	return compare(a, b) != 0;
+}
+
+inline bool operator < (const big_integer &a, uint32_t b) {
+	return compare(a, b) < 0;
+}
+
+inline bool operator > (const big_integer &a, uint32_t b) {
+	return compare(a, b) > 0;
+}
+
+inline bool operator <= (const big_integer &a, uint32_t b) {
+	return compare(a, b) <= 0;
+}
+
+inline bool operator >= (const big_integer &a, uint32_t b) {
+	return compare(a, b) >= 0;
+}
+
+inline bool operator == (uint32_t a, const big_integer &b) {
+	return compare(b, a) == 0;
+}
+
+inline bool operator != (uint32_t a, const big_integer &b) {
+	return compare(b, a) != 0;
+}
+
+inline bool operator < (uint32_t a, const big_integer &b) {
+	return compare(b, a) > 0;
+}
+
+inline bool operator > (uint32_t a, const big_integer &b) {
+	return compare(b, a) < 0;
+}
+
+inline bool operator <= (uint32_t a, const big_integer &b) {
+	return compare(b, a) >= 0;
+}
+
+inline bool operator >= (uint32_t a, const big_integer &b) {
+	return compare(b, a) <= 0;
+}
+
+#ifdef BIGINT_THREE_WAY_COMPARISON
+inline std::strong_ordering operator <=> (const big_integer &a, const big_integer &b) {
+	return compare(a, b) <=> 0;
+}
+
+inline std::strong_ordering operator <=> (const big_integer &a, int b) {
+	return compare(a, b) <=> 0;
+}
+
+inline std::strong_ordering operator <=> (const big_integer &a, uint32_t b) {
+	return compare(a, b) <=> 0;
+}
+#endif
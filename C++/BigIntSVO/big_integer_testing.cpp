@@ -73,6 +73,27 @@ TEST(correctness, self_assignment)
     EXPECT_TRUE(a == 5);
 }
 
+TEST(correctness, move_ctor)
+{
+    big_integer a("100000000000000000000000000000");
+    big_integer b = std::move(a);
+    a = 5;
+
+    EXPECT_EQ(b, big_integer("100000000000000000000000000000"));
+    EXPECT_EQ(a, 5);
+}
+
+TEST(correctness, small_overflow)
+{
+    big_integer a = std::numeric_limits<int>::max();
+    big_integer b = std::numeric_limits<int>::min();
+
+    EXPECT_EQ(a + 1, big_integer("2147483648"));
+    EXPECT_EQ(b - 1, big_integer("-2147483649"));
+    EXPECT_TRUE(b < a);
+    EXPECT_TRUE(b - 1 < b);
+}
+
 TEST(correctness, assignment_return_value)
 {
     big_integer a = 4;
@@ -680,3 +701,90 @@ TEST(correctness, mul_merge_randomized)
         EXPECT_TRUE(a == b);
     }
 }
+
+namespace
+{
+    big_integer random_big_integer(size_t limbs)
+    {
+        big_integer r = 0;
+        for (size_t i = 0; i != limbs; ++i)
+            r = (r << 32) + big_integer((uint32_t)rand() * 2654435761u + (uint32_t)rand());
+        return rand() % 2 ? r : -r;
+    }
+}
+
+TEST(correctness, bitwise_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1), b = random_big_integer(rand() % 80 + 1);
+        big_integer x = a & b, y = a | b, z = a ^ b;
+        EXPECT_EQ(x + y, a + b);
+        EXPECT_EQ(z, y - x);
+        EXPECT_EQ(~a, -a - 1);
+        EXPECT_EQ(andnot(a, b), a & ~b);
+        EXPECT_EQ(andnot(a, b) | x, a);
+        EXPECT_EQ(z ^ b, a);
+    }
+}
+
+TEST(correctness, shift_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1);
+        int k = rand() % 1200;
+        big_integer p = big_integer(1) << k, r = a >> k;
+        EXPECT_EQ(a << k, a * p);
+        EXPECT_EQ((a << k) >> k, a);
+        EXPECT_TRUE(r * p <= a && a < (r + 1) * p); //rounds towards minus infinity
+        big_integer b = a, c = a; //c shares the buffer, shifting b mustn't touch it
+        b <<= k;
+        b >>= k + 32;
+        EXPECT_EQ(b, a >> 32);
+        EXPECT_EQ(c, a);
+        EXPECT_EQ(a << -k, r);
+    }
+    EXPECT_EQ(big_integer(-5) >> 1000, -1);
+    EXPECT_EQ(big_integer(5) >> 1000, 0);
+}
+
+TEST(correctness, compare_randomized)
+{
+    for (int i = 0; i < 300; ++i) {
+        big_integer a = random_big_integer(rand() % 80 + 1), c = a;
+        big_integer b = a ^ (big_integer(1) << (rand() % 2600)); //differs from a in a single bit, anywhere
+        big_integer d = random_big_integer(rand() % 80 + 1);
+        EXPECT_TRUE(a == c && !(a != c) && !(a < c) && a <= c);
+        EXPECT_TRUE(a != b && !(a == b));
+        EXPECT_EQ(a < b, a - b < 0);
+        EXPECT_EQ(b < a, b - a < 0);
+        EXPECT_EQ(a < d, a - d < 0);
+        EXPECT_EQ(a == d, a - d == 0);
+        EXPECT_EQ((a - b) + b, c); //normalize has to drop the cancelled high limbs
+        EXPECT_EQ(-a + a, 0);
+    }
+}
+
+TEST(correctness, three_way_compare)
+{
+    std::vector<big_integer> v;
+    for (int i = 0; i < 200; ++i)
+        v.push_back(random_big_integer(rand() % 6 + 1) >> (rand() % 150));
+    for (int x : {0, 1, -1, INT32_MAX, INT32_MIN})
+        v.push_back(x);
+    v.push_back(big_integer(UINT32_MAX));
+    v.push_back(big_integer((uint32_t)1 << 31));
+    std::sort(v.begin(), v.end());
+    for (size_t i = 0; i + 1 < v.size(); ++i) {
+        EXPECT_LE(v[i], v[i + 1]);
+        EXPECT_EQ(compare(v[i], v[i + 1]), v[i] == v[i + 1] ? 0 : -1);
+        EXPECT_EQ(compare(v[i + 1], v[i]), v[i] == v[i + 1] ? 0 : 1);
+    }
+    for (const big_integer &a : v)
+        for (uint32_t w : {0u, 1u, 5u, (uint32_t)INT32_MAX, (uint32_t)1 << 31, UINT32_MAX - 1, UINT32_MAX}) {
+            EXPECT_EQ(compare(a, w), compare(a, big_integer(w)));
+            EXPECT_EQ(compare(a, (int)w), compare(a, big_integer((int)w)));
+            EXPECT_EQ(a < w, a < big_integer(w));
+            EXPECT_EQ(w <= a, big_integer(w) <= a);
+            EXPECT_EQ((int)w == a, big_integer((int)w) == a);
+        }
+}
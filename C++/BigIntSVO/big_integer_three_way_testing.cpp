@@ -0,0 +1,44 @@
+//built as C++20 next to the C++14 tests, so that operator <=> gets compiled and checked at all
+#include <cstdint>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "big_integer.h"
+
+#ifndef BIGINT_THREE_WAY_COMPARISON
+#error "this test needs a compiler with three-way comparison, it is only built with -std=c++20"
+#endif
+
+namespace
+{
+    int sign(std::strong_ordering o) {
+        return o < 0 ? -1 : o > 0 ? 1 : 0;
+    }
+}
+
+TEST(correctness, three_way_operator)
+{
+    const big_integer big = big_integer(1) << 100;
+    std::vector<big_integer> v = { -big, big_integer(INT32_MIN) - 1, INT32_MIN, -1, 0, 1, INT32_MAX,
+                                   big_integer(UINT32_MAX), big };
+    for (size_t i = 0; i < v.size(); ++i)
+        for (size_t j = 0; j < v.size(); ++j) {
+            const int expected = (i > j) - (i < j);
+            EXPECT_EQ(sign(v[i] <=> v[j]), expected);
+        }
+
+    for (const big_integer &a : v)
+        for (int w : { INT32_MIN, -1, 0, 1, INT32_MAX }) {
+            EXPECT_EQ(sign(a <=> w), compare(a, big_integer(w)));
+            EXPECT_EQ(sign(w <=> a), -compare(a, big_integer(w))); //the reversed candidate
+        }
+    for (const big_integer &a : v)
+        for (uint32_t w : { 0u, (uint32_t)1 << 31, UINT32_MAX }) {
+            EXPECT_EQ(sign(a <=> w), compare(a, big_integer(w)));
+            EXPECT_EQ(sign(w <=> a), -compare(a, big_integer(w)));
+        }
+
+    EXPECT_TRUE((big <=> big_integer(big)) == std::strong_ordering::equal);
+    EXPECT_TRUE((5 <=> big_integer(7)) == std::strong_ordering::less);
+    EXPECT_TRUE((UINT32_MAX <=> big_integer(-1)) == std::strong_ordering::greater);
+}